@@ -0,0 +1,331 @@
+/**
+ * @file app_conf.h
+ * Configuration file of the watch application
+ *
+ * Every option can be overridden from the build system
+ * (e.g. `-DAPP_TELEMETRY=1`) as all of them are guarded by `#ifndef`.
+ */
+
+#ifndef APP_CONF_H
+#define APP_CONF_H
+
+/*====================
+   DISPLAY SETTINGS
+ *====================*/
+
+/*Panel: SCREEN_WIDTH, SCREEN_HEIGHT, the default draw buffers, the fonts and the layout
+ *offsets come from the profile selected by APP_DISPLAY_PROFILE (default: 1.47" 172x320)*/
+#include "display_profile.h"
+
+/*How the SDL backend moves the flushed pixels to the window
+ *APP_SDL_FLUSH_TEXTURE:    copy the rows into a persistent RGB565 streaming texture
+ *APP_SDL_FLUSH_DRAW_POINT: one SDL_RenderDrawPoint per pixel (legacy, for comparison only)*/
+#define APP_SDL_FLUSH_TEXTURE    0
+#define APP_SDL_FLUSH_DRAW_POINT 1
+
+#ifndef APP_SDL_FLUSH_MODE
+    #define APP_SDL_FLUSH_MODE APP_SDL_FLUSH_TEXTURE
+#endif
+
+/*Pixel format of the panel texture with APP_SDL_FLUSH_TEXTURE
+ *APP_SDL_TEXTURE_RGB565:   same as lv_color_t, the rows are copied as they are
+ *APP_SDL_TEXTURE_ARGB8888: the rows are converted by pixel_conv.h (for renderers without RGB565)*/
+#define APP_SDL_TEXTURE_RGB565   0
+#define APP_SDL_TEXTURE_ARGB8888 1
+
+#ifndef APP_SDL_TEXTURE_FORMAT
+    #define APP_SDL_TEXTURE_FORMAT APP_SDL_TEXTURE_RGB565
+#endif
+
+/*1: Flush asynchronously: the flush callback hands the areas to a transfer thread
+ *which signals `lv_disp_flush_ready()` when done, so rendering and transfer overlap*/
+#ifndef APP_FLUSH_ASYNC
+    #define APP_FLUSH_ASYNC 0
+#endif
+#if APP_FLUSH_ASYNC
+    /*Simulated bit rate of the panel bus, e.g. 40000000 for a 40 MHz SPI (0: no delay)*/
+    #ifndef APP_FLUSH_BUS_HZ
+        #define APP_FLUSH_BUS_HZ 0
+    #endif
+#endif
+
+/*Window zoom of the simulator (the logical resolution is not affected), APP_SDL_ZOOM
+ *defaults to the zoom of the display profile*/
+
+/*Default draw buffer strategy (see draw_buf.h) APP_DRAW_BUF_MODE and the lines per buffer with
+ *DRAW_BUF_PARTIAL APP_DRAW_BUF_LINES are set by the display profile.
+ *They can be changed with `--buf=<mode>` and `--buf=partial:<lines>`.*/
+
+/*Draw unit of LVGL (see draw_backend.h), can be changed with `--draw=<backend>`.
+ *Set by the APP_DRAW_BACKEND CMake option, which also builds the accelerator into LVGL.*/
+#ifndef APP_DRAW_BACKEND
+    #define APP_DRAW_BACKEND DRAW_BACKEND_AUTO
+#endif
+
+/*Rendering tier of the text (see render_tier.h), can be changed with `--render=full|fast`*/
+#ifndef APP_RENDER_TIER
+    #define APP_RENDER_TIER RENDER_TIER_FAST
+#endif
+
+/*1: Draw the clock digits from glyphs pre-rendered in the display's color format
+ *(see glyph_cache.h) instead of rendering the anti-aliased letters on every change*/
+#ifndef APP_GLYPH_CACHE
+    #define APP_GLYPH_CACHE 1
+#endif
+
+/*1: Merge, align and reorder the invalidated areas before each refresh (see flush_sched.h)*/
+#ifndef APP_FLUSH_SCHED
+    #define APP_FLUSH_SCHED 1
+#endif
+#if APP_FLUSH_SCHED
+    /*Column alignment of the panel windows (power of 2), 2 for the even windows of the ST7789*/
+    #ifndef APP_FLUSH_SCHED_ALIGN
+        #define APP_FLUSH_SCHED_ALIGN 2
+    #endif
+
+    /*Cost of setting up one more window (CASET/RASET/RAMWR) in pixels of transfer time.
+     *Two areas are merged if the joined one has at most this many more pixels.*/
+    #ifndef APP_FLUSH_SCHED_WINDOW_COST
+        #define APP_FLUSH_SCHED_WINDOW_COST 256
+    #endif
+
+    /*Refresh rate of the panel to simulate the scan line without a TE signal*/
+    #ifndef APP_FLUSH_SCHED_PANEL_HZ
+        #define APP_FLUSH_SCHED_PANEL_HZ 60
+    #endif
+#endif
+
+/*1: Schedule the LVGL refreshes right after the vsync of the display and lower the
+ *refresh rate while idle (see frame_pacer.h)*/
+#ifndef APP_FRAME_PACER
+    #define APP_FRAME_PACER 1
+#endif
+#if APP_FRAME_PACER
+    /*Refresh rate assumed until vsyncs are observed, if the display doesn't report one*/
+    #ifndef APP_FRAME_PACER_DEF_HZ
+        #define APP_FRAME_PACER_DEF_HZ 60
+    #endif
+
+    /*Refresh rate while idle (a clock ticking once per second)*/
+    #ifndef APP_FRAME_PACER_IDLE_HZ
+        #define APP_FRAME_PACER_IDLE_HZ 1
+    #endif
+
+    /*Time without animations and input before going idle*/
+    #ifndef APP_FRAME_PACER_IDLE_DELAY
+        #define APP_FRAME_PACER_IDLE_DELAY 500  /*[ms]*/
+    #endif
+#endif
+
+/*1: Run the large blends of the renderer and the pixel conversion of the flushes
+ *in bands on a worker pool (see par_render.h)*/
+#ifndef APP_PAR_RENDER
+    #define APP_PAR_RENDER 1
+#endif
+#if APP_PAR_RENDER
+    /*Threads including the LVGL thread, 0: one per CPU*/
+    #ifndef APP_PAR_RENDER_THREADS
+        #define APP_PAR_RENDER_THREADS 0
+    #endif
+
+    #ifndef APP_PAR_RENDER_MAX_THREADS
+        #define APP_PAR_RENDER_MAX_THREADS 8
+    #endif
+
+    /*Smaller blends run on the LVGL thread alone (waking the workers costs more).
+     *With DRAW_BUF_PARTIAL the chunks are smaller than this, use full or direct buffers.*/
+    #ifndef APP_PAR_RENDER_MIN_PX
+        #define APP_PAR_RENDER_MIN_PX 8192
+    #endif
+
+    /*Minimal height of a band*/
+    #ifndef APP_PAR_RENDER_MIN_ROWS
+        #define APP_PAR_RENDER_MIN_ROWS 8
+    #endif
+#endif
+
+/*Delay before building the time screen in the background while the loading screen is shown*/
+#ifndef APP_SCREEN_PREBUILD_DELAY
+    #define APP_SCREEN_PREBUILD_DELAY 500  /*[ms]*/
+#endif
+
+/*Read the RTC again every N minutes (a divisor of 60), in between the time follows the tick.
+ *Corrects the drift of the tick and picks up DST changes, which happen on quarter hours.*/
+#ifndef APP_TIMEKEEPER_SYNC_MIN
+    #define APP_TIMEKEEPER_SYNC_MIN 15
+#endif
+
+/*1: Always-on mode after a while without input on the time screen: the clock shows
+ *HH:MM and is updated once a minute and the panel is switched to its idle mode (8 colours)*/
+#ifndef APP_AOD
+    #define APP_AOD 1
+#endif
+#if APP_AOD
+    #ifndef APP_AOD_TIMEOUT
+        #define APP_AOD_TIMEOUT 15000  /*[ms]*/
+    #endif
+#endif
+
+/*====================
+   TICK SETTINGS
+ *====================*/
+
+/*Default source of the LVGL tick (see app_tick.h)
+ *APP_TICK_SOURCE_MONOTONIC: clock_gettime(CLOCK_MONOTONIC)
+ *APP_TICK_SOURCE_SDL:       SDL_GetTicks64()
+ *APP_TICK_SOURCE_ISR:       counter advanced by `app_tick_inc()` from a hardware timer interrupt*/
+#define APP_TICK_SOURCE_MONOTONIC 0
+#define APP_TICK_SOURCE_SDL       1
+#define APP_TICK_SOURCE_ISR       2
+
+#ifndef APP_TICK_SOURCE
+    #define APP_TICK_SOURCE APP_TICK_SOURCE_MONOTONIC
+#endif
+
+/*====================
+   MAIN LOOP SETTINGS
+ *====================*/
+
+/*How the main loop waits between two `lv_timer_handler()` calls
+ *APP_LOOP_POLL: poll the events and sleep a fixed `APP_LOOP_POLL_DELAY` ms
+ *APP_LOOP_WAIT: block in SDL_WaitEventTimeout() until an event arrives or the next LVGL timer is due*/
+#define APP_LOOP_POLL 0
+#define APP_LOOP_WAIT 1
+
+#ifndef APP_LOOP_MODE
+    #define APP_LOOP_MODE APP_LOOP_WAIT
+#endif
+
+#if APP_LOOP_MODE == APP_LOOP_POLL
+    #ifndef APP_LOOP_POLL_DELAY
+        #define APP_LOOP_POLL_DELAY 5       /*[ms]*/
+    #endif
+#else
+    /*Upper limit of a single wait (also used when no LVGL timer is active)*/
+    #ifndef APP_LOOP_MAX_WAIT
+        #define APP_LOOP_MAX_WAIT 1000      /*[ms]*/
+    #endif
+#endif
+
+/*1: Print the number of main loop wakeups once per second*/
+#ifndef APP_LOOP_STATS
+    #define APP_LOOP_STATS 0
+#endif
+
+/*====================
+   INPUT SETTINGS
+ *====================*/
+
+/*Touch events queued until LVGL reads them (power of 2, see input_queue.h)*/
+#ifndef APP_INPUT_QUEUE_SIZE
+    #define APP_INPUT_QUEUE_SIZE 64
+#endif
+
+/*Longer input-to-photon delays are not measured (the event didn't cause a redraw)*/
+#ifndef APP_INPUT_LATENCY_MAX
+    #define APP_INPUT_LATENCY_MAX 500   /*[ms]*/
+#endif
+
+/*====================
+   BOOT SETTINGS
+ *====================*/
+
+/*1: Timestamp the startup phases and print a report with the time to the first pixel*/
+#ifndef APP_BOOT_PROF
+    #define APP_BOOT_PROF 1
+#endif
+#if APP_BOOT_PROF
+    /*Time allowed until "Welcome" is on the screen, the report flags if it's exceeded*/
+    #ifndef APP_BOOT_BUDGET_MS
+        #define APP_BOOT_BUDGET_MS 300
+    #endif
+#endif
+
+/*1: Decode the splash pre-rendered at build time (see splash.h) into the panel before lv_init().
+ *Set by the APP_SPLASH CMake option, which generates the blob.*/
+#ifndef APP_SPLASH
+    #define APP_SPLASH 0
+#endif
+
+/*1: Place the screen elements from the layout table resolved at build time (see ui_layout.h).
+ *Set by the APP_UI_LAYOUT_AOT CMake option, which generates the table.*/
+#ifndef APP_UI_LAYOUT_AOT
+    #define APP_UI_LAYOUT_AOT 0
+#endif
+
+/*1: Replace LVGL's default theme with the minimal one of app_theme.h: the objects
+ *carry no unused card, scrollbar, transition and shadow styles. Can be changed with --theme=.*/
+#ifndef APP_THEME_MINIMAL
+    #define APP_THEME_MINIMAL 1
+#endif
+
+/*1: Draw the screens with the subsets of the profile's fonts generated by tools/font_subset
+ *(see app_font.h). Set by the APP_FONT_SUBSET CMake option, which generates them.*/
+#ifndef APP_FONT_SUBSET
+    #define APP_FONT_SUBSET 0
+#endif
+
+/*====================
+   MEMORY SETTINGS
+ *====================*/
+
+/*1: LVGL allocates from the pools and the arena of app_mem.h (LV_MEM_CUSTOM).
+ *Set by the APP_MEM_CUSTOM CMake option, as lv_conf.h has to see the same value.*/
+#ifndef APP_MEM_CUSTOM
+    #define APP_MEM_CUSTOM 0
+#endif
+#if APP_MEM_CUSTOM
+    /*Number of blocks per size class*/
+    #ifndef APP_MEM_POOL_16
+        #define APP_MEM_POOL_16  128
+    #endif
+    #ifndef APP_MEM_POOL_32
+        #define APP_MEM_POOL_32  128
+    #endif
+    #ifndef APP_MEM_POOL_64
+        #define APP_MEM_POOL_64  96
+    #endif
+    #ifndef APP_MEM_POOL_128
+        #define APP_MEM_POOL_128 32
+    #endif
+    #ifndef APP_MEM_POOL_256
+        #define APP_MEM_POOL_256 16
+    #endif
+
+    /*Size of the arena for the screens built at startup (multiple of 8)*/
+    #ifndef APP_MEM_ARENA_SIZE
+        #define APP_MEM_ARENA_SIZE (16U * 1024U)  /*[bytes]*/
+    #endif
+#endif
+
+/*====================
+   TELEMETRY SETTINGS
+ *====================*/
+
+/*1: Record the render time, flush time, refreshed pixels and timer handler overhead of every frame*/
+#ifndef APP_TELEMETRY
+    #define APP_TELEMETRY 0
+#endif
+#if APP_TELEMETRY
+    /*Number of frame records kept until they are read (power of 2)*/
+    #ifndef APP_TELEMETRY_RING_SIZE
+        #define APP_TELEMETRY_RING_SIZE 256
+    #endif
+
+    /*Print a summary (and write the CSV file if set) with this period, 0 to only dump on demand*/
+    #ifndef APP_TELEMETRY_DUMP_PERIOD
+        #define APP_TELEMETRY_DUMP_PERIOD 5000  /*[ms]*/
+    #endif
+#endif
+
+/*================
+   TRACE SETTINGS
+ *================*/
+
+/*1: `--record=file` captures the tick, touch and wall clock inputs of the render loop
+ *for the deterministic replay (see trace.h)*/
+#ifndef APP_TRACE
+    #define APP_TRACE 1
+#endif
+
+#endif /*APP_CONF_H*/
@@ -0,0 +1,38 @@
+/**
+ * @file app_font.h
+ * Fonts of the screens: the fonts of the display profile or their subsets
+ *
+ * With `APP_FONT_SUBSET` the screens use fonts generated by tools/font_subset
+ * at build time. They only contain the characters listed here, optionally at a
+ * lower bpp or compressed (`LV_USE_FONT_COMPRESSED`); the metrics and the
+ * kerning are the ones of the profile's fonts, so the layout doesn't change.
+ * Without it the full Montserrat fonts of LVGL are used.
+ */
+
+#ifndef APP_FONT_H
+#define APP_FONT_H
+
+#include "lvgl/lvgl.h"
+#include "app_conf.h"
+#include "clock_widget.h"
+#include "time_fmt.h"
+
+/*Characters drawn with each font ("Welcome" is measured by ui_layout.c, the subset takes it from there)*/
+#define APP_FONT_CLOCK_CHARS CLOCK_WIDGET_CHARS
+#define APP_FONT_DATE_CHARS  TIME_FMT_DATE_CHARS
+
+#if APP_FONT_SUBSET
+    extern const lv_font_t app_font_welcome;
+    extern const lv_font_t app_font_clock;
+    extern const lv_font_t app_font_date;
+
+    #define APP_UI_FONT_WELCOME app_font_welcome
+    #define APP_UI_FONT_CLOCK   app_font_clock
+    #define APP_UI_FONT_DATE    app_font_date
+#else
+    #define APP_UI_FONT_WELCOME APP_FONT_WELCOME
+    #define APP_UI_FONT_CLOCK   APP_FONT_CLOCK
+    #define APP_UI_FONT_DATE    APP_FONT_DATE
+#endif
+
+#endif /*APP_FONT_H*/
@@ -0,0 +1,323 @@
+/**
+ * @file app_mem.c
+ * Pool and arena allocator of LVGL (`LV_MEM_CUSTOM`)
+ */
+
+#include "app_mem.h"
+#include "app_conf.h"
+
+#if APP_MEM_CUSTOM
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MIN_BLOCK_SIZE  16
+#define MAX_BLOCK_SIZE  (MIN_BLOCK_SIZE << (APP_MEM_CLASS_CNT - 1))
+
+#define TOTAL_BLOCKS (APP_MEM_POOL_16 + APP_MEM_POOL_32 + APP_MEM_POOL_64 + APP_MEM_POOL_128 + APP_MEM_POOL_256)
+#define POOL_BYTES   (APP_MEM_POOL_16 * 16 + APP_MEM_POOL_32 * 32 + APP_MEM_POOL_64 * 64 + \
+                      APP_MEM_POOL_128 * 128 + APP_MEM_POOL_256 * 256)
+
+// Heap blocks start with their size, padded to keep the alignment of malloc()
+#define HEAP_HDR_SIZE 16
+
+typedef struct free_block {
+    struct free_block *next;
+} free_block_t;
+
+typedef struct {
+    uint8_t *start;
+    uint8_t *end;
+    free_block_t *free_list;
+    uint16_t *req_sizes;            /*Requested size of every block (0: free)*/
+} pool_t;
+
+static const uint32_t pool_block_cnts[APP_MEM_CLASS_CNT] = {
+    APP_MEM_POOL_16, APP_MEM_POOL_32, APP_MEM_POOL_64, APP_MEM_POOL_128, APP_MEM_POOL_256
+};
+
+static uint64_t pool_buf[POOL_BYTES / sizeof(uint64_t)];
+static uint16_t req_size_buf[TOTAL_BLOCKS];
+static pool_t pools[APP_MEM_CLASS_CNT];
+static bool pools_ready;
+
+// Arena blocks start with their size (8 bytes to keep 8 byte alignment)
+static uint64_t arena_buf[APP_MEM_ARENA_SIZE / sizeof(uint64_t)];
+static uint32_t arena_pos;
+static uint32_t arena_last;         /*Offset of the last allocated arena block, to grow it in place*/
+static bool arena_active;
+
+static app_mem_stats_t stats;
+
+static void pools_init(void);
+static int get_class(size_t size);
+static int find_pool(const void *ptr);
+static bool in_arena(const void *ptr);
+static size_t get_size(const void *ptr);
+static void *pool_alloc(int c, size_t size);
+static void *arena_alloc(size_t size);
+static void *heap_alloc(size_t size);
+static void stats_add(int32_t diff);
+
+void *app_mem_alloc(size_t size)
+{
+    if (!pools_ready) pools_init();
+
+    void *p = NULL;
+    if (arena_active) p = arena_alloc(size);
+
+    int c = get_class(size);
+    if (!p && c >= 0) {
+        p = pool_alloc(c, size);
+        if (!p) stats.classes[c].fallback_cnt++;
+    }
+
+    if (!p) p = heap_alloc(size);
+    if (p) stats_add((int32_t)size);
+
+    return p;
+}
+
+void app_mem_free(void *ptr)
+{
+    if (!ptr) return;
+
+    int c = find_pool(ptr);
+    if (c >= 0) {
+        pool_t *pool = &pools[c];
+        uint32_t idx = (uint32_t)((uint8_t *)ptr - pool->start) / stats.classes[c].block_size;
+
+        stats_add(-(int32_t)pool->req_sizes[idx]);
+        stats.classes[c].req_bytes -= pool->req_sizes[idx];
+        stats.classes[c].used--;
+        pool->req_sizes[idx] = 0;
+
+        free_block_t *b = ptr;
+        b->next = pool->free_list;
+        pool->free_list = b;
+    } else if (in_arena(ptr)) {
+        uint32_t size = (uint32_t)get_size(ptr);
+        stats_add(-(int32_t)size);
+        stats.arena_freed += size;
+    } else {
+        uint8_t *hdr = (uint8_t *)ptr - HEAP_HDR_SIZE;
+        size_t size = *(size_t *)hdr;
+        stats_add(-(int32_t)size);
+        stats.heap_used -= (uint32_t)size;
+        stats.heap_cnt--;
+        free(hdr);
+    }
+}
+
+void *app_mem_realloc(void *ptr, size_t size)
+{
+    if (!ptr) return app_mem_alloc(size);
+
+    size_t old_size = get_size(ptr);
+    int c = find_pool(ptr);
+
+    // Still fits into its block: nothing to move (the label texts mostly take this path)
+    if (c >= 0 && size <= stats.classes[c].block_size) {
+        pool_t *pool = &pools[c];
+        uint32_t idx = (uint32_t)((uint8_t *)ptr - pool->start) / stats.classes[c].block_size;
+        pool->req_sizes[idx] = (uint16_t)size;
+        stats.classes[c].req_bytes += (uint32_t)size - (uint32_t)old_size;
+        stats_add((int32_t)size - (int32_t)old_size);
+        return ptr;
+    }
+
+    // The last arena block can grow in place
+    if (in_arena(ptr) && (uint8_t *)ptr - 8 == (uint8_t *)arena_buf + arena_last) {
+        uint32_t end = arena_last + 8 + (((uint32_t)size + 7) & ~7u);
+        if (end <= APP_MEM_ARENA_SIZE) {
+            *(uint64_t *)((uint8_t *)ptr - 8) = size;
+            stats.arena_used = end;
+            arena_pos = end;
+            stats_add((int32_t)size - (int32_t)old_size);
+            return ptr;
+        }
+    }
+
+    void *new_ptr = app_mem_alloc(size);
+    if (!new_ptr) return NULL;
+    memcpy(new_ptr, ptr, old_size < size ? old_size : size);
+    app_mem_free(ptr);
+
+    return new_ptr;
+}
+
+void app_mem_arena_begin(void)
+{
+    arena_active = true;
+}
+
+void app_mem_arena_end(void)
+{
+    arena_active = false;
+}
+
+void app_mem_get_stats(app_mem_stats_t *s)
+{
+    if (!pools_ready) pools_init();
+
+    uint32_t block_bytes = 0;
+    uint32_t req_bytes = 0;
+    for(int c = 0; c < APP_MEM_CLASS_CNT; c++) {
+        block_bytes += stats.classes[c].used * stats.classes[c].block_size;
+        req_bytes += stats.classes[c].req_bytes;
+    }
+    stats.frag_pct = block_bytes ? (uint8_t)(100 - (uint64_t)req_bytes * 100 / block_bytes) : 0;
+
+    *s = stats;
+}
+
+void app_mem_print_stats(void)
+{
+    app_mem_stats_t s;
+    app_mem_get_stats(&s);
+
+    printf("[mem] used %u B, peak %u B, pool frag %u%%, arena %u/%u B (%u B freed), heap %u B in %u blocks\n",
+           (unsigned)s.used, (unsigned)s.peak, (unsigned)s.frag_pct,
+           (unsigned)s.arena_used, (unsigned)s.arena_size, (unsigned)s.arena_freed,
+           (unsigned)s.heap_used, (unsigned)s.heap_cnt);
+    for(int c = 0; c < APP_MEM_CLASS_CNT; c++) {
+        const app_mem_class_stats_t *cs = &s.classes[c];
+        printf("[mem]   %3u B: %u/%u used, peak %u, %u allocs, %u to heap\n",
+               (unsigned)cs->block_size, (unsigned)cs->used, (unsigned)cs->block_cnt, (unsigned)cs->peak,
+               (unsigned)cs->alloc_cnt, (unsigned)cs->fallback_cnt);
+    }
+}
+
+/**
+ * Carve the pools from the static buffer and chain their free blocks
+ */
+static void pools_init(void)
+{
+    uint8_t *p = (uint8_t *)pool_buf;
+    uint16_t *req_sizes = req_size_buf;
+
+    for(int c = 0; c < APP_MEM_CLASS_CNT; c++) {
+        uint32_t block_size = MIN_BLOCK_SIZE << c;
+        pool_t *pool = &pools[c];
+
+        pool->start = p;
+        pool->end = p + pool_block_cnts[c] * block_size;
+        pool->req_sizes = req_sizes;
+        pool->free_list = NULL;
+        // Chained backwards so that the first allocations get the lowest addresses
+        for(uint32_t i = pool_block_cnts[c]; i > 0; i--) {
+            free_block_t *b = (free_block_t *)(p + (i - 1) * block_size);
+            b->next = pool->free_list;
+            pool->free_list = b;
+        }
+
+        stats.classes[c].block_size = block_size;
+        stats.classes[c].block_cnt = pool_block_cnts[c];
+        p = pool->end;
+        req_sizes += pool_block_cnts[c];
+    }
+
+    stats.arena_size = APP_MEM_ARENA_SIZE;
+    pools_ready = true;
+}
+
+/**
+ * Get the smallest size class holding `size` bytes, -1 if it's too big for the pools
+ */
+static int get_class(size_t size)
+{
+    if (size > MAX_BLOCK_SIZE) return -1;
+
+    int c = 0;
+    while ((size_t)(MIN_BLOCK_SIZE << c) < size) c++;
+
+    return c;
+}
+
+static int find_pool(const void *ptr)
+{
+    const uint8_t *p = ptr;
+    if (p < (const uint8_t *)pool_buf || p >= (const uint8_t *)pool_buf + POOL_BYTES) return -1;
+
+    for(int c = 0; c < APP_MEM_CLASS_CNT; c++) {
+        if (p >= pools[c].start && p < pools[c].end) return c;
+    }
+
+    return -1;
+}
+
+static bool in_arena(const void *ptr)
+{
+    const uint8_t *p = ptr;
+
+    return p >= (const uint8_t *)arena_buf && p < (const uint8_t *)arena_buf + APP_MEM_ARENA_SIZE;
+}
+
+/**
+ * Get the requested size of an allocated block
+ */
+static size_t get_size(const void *ptr)
+{
+    int c = find_pool(ptr);
+    if (c >= 0) {
+        uint32_t idx = (uint32_t)((const uint8_t *)ptr - pools[c].start) / stats.classes[c].block_size;
+        return pools[c].req_sizes[idx];
+    }
+    if (in_arena(ptr)) return (size_t) * (const uint64_t *)((const uint8_t *)ptr - 8);
+
+    return *(const size_t *)((const uint8_t *)ptr - HEAP_HDR_SIZE);
+}
+
+static void *pool_alloc(int c, size_t size)
+{
+    pool_t *pool = &pools[c];
+    app_mem_class_stats_t *cs = &stats.classes[c];
+
+    free_block_t *b = pool->free_list;
+    if (!b) return NULL;
+    pool->free_list = b->next;
+
+    uint32_t idx = (uint32_t)((uint8_t *)b - pool->start) / cs->block_size;
+    pool->req_sizes[idx] = (uint16_t)size;
+    cs->req_bytes += (uint32_t)size;
+    cs->alloc_cnt++;
+    cs->used++;
+    if (cs->used > cs->peak) cs->peak = cs->used;
+
+    return b;
+}
+
+static void *arena_alloc(size_t size)
+{
+    uint32_t end = arena_pos + 8 + (((uint32_t)size + 7) & ~7u);
+    if (size > APP_MEM_ARENA_SIZE || end > APP_MEM_ARENA_SIZE) return NULL;
+
+    uint8_t *hdr = (uint8_t *)arena_buf + arena_pos;
+    *(uint64_t *)hdr = size;
+    arena_last = arena_pos;
+    arena_pos = end;
+    stats.arena_used = end;
+
+    return hdr + 8;
+}
+
+static void *heap_alloc(size_t size)
+{
+    uint8_t *hdr = malloc(HEAP_HDR_SIZE + size);
+    if (!hdr) return NULL;
+
+    *(size_t *)hdr = size;
+    stats.heap_used += (uint32_t)size;
+    stats.heap_cnt++;
+
+    return hdr + HEAP_HDR_SIZE;
+}
+
+static void stats_add(int32_t diff)
+{
+    stats.used = (uint32_t)((int32_t)stats.used + diff);
+    if (stats.used > stats.peak) stats.peak = stats.used;
+}
+
+#endif /*APP_MEM_CUSTOM*/
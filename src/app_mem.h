@@ -0,0 +1,74 @@
+/**
+ * @file app_mem.h
+ * Pool and arena allocator of LVGL (`LV_MEM_CUSTOM`)
+ *
+ * - Small blocks come from fixed size-class pools: a freed block is reused by
+ *   the next allocation of the same class, so the label texts reallocated
+ *   every second can't fragment the memory.
+ * - Between `app_mem_arena_begin()` and `app_mem_arena_end()` allocations are
+ *   bumped from an arena. Use it for objects which are never deleted (e.g. the
+ *   screens built at startup): freeing an arena block doesn't reclaim it.
+ * - Bigger blocks, or blocks of an exhausted pool, go to the system heap.
+ *
+ * Enabled with the `APP_MEM_CUSTOM` CMake option.
+ */
+
+#ifndef APP_MEM_H
+#define APP_MEM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*Number of size classes: 16, 32, 64, 128 and 256 bytes*/
+#define APP_MEM_CLASS_CNT 5
+
+typedef struct {
+    uint32_t block_size;
+    uint32_t block_cnt;
+    uint32_t used;              /*Blocks in use*/
+    uint32_t peak;              /*Most blocks in use at once*/
+    uint32_t alloc_cnt;         /*Allocations served by this class*/
+    uint32_t fallback_cnt;      /*Allocations of this class sent to the heap as the pool was full*/
+    uint32_t req_bytes;         /*Requested bytes of the blocks in use*/
+} app_mem_class_stats_t;
+
+typedef struct {
+    app_mem_class_stats_t classes[APP_MEM_CLASS_CNT];
+    uint32_t arena_size;
+    uint32_t arena_used;
+    uint32_t arena_freed;       /*Arena bytes freed (not reusable)*/
+    uint32_t heap_used;         /*Bytes on the system heap*/
+    uint32_t heap_cnt;
+    uint32_t used;              /*Requested bytes in use in total*/
+    uint32_t peak;
+    uint8_t frag_pct;           /*Unused part of the pool blocks in use (internal fragmentation)*/
+} app_mem_stats_t;
+
+void *app_mem_alloc(size_t size);
+
+void app_mem_free(void *ptr);
+
+void *app_mem_realloc(void *ptr, size_t size);
+
+/**
+ * Allocate from the arena until `app_mem_arena_end()`
+ */
+void app_mem_arena_begin(void);
+
+/**
+ * Go back to the pools
+ */
+void app_mem_arena_end(void);
+
+/**
+ * Get the statistics of the allocator
+ */
+void app_mem_get_stats(app_mem_stats_t *stats);
+
+/**
+ * Print the statistics to stdout
+ */
+void app_mem_print_stats(void);
+
+#endif /*APP_MEM_H*/
@@ -0,0 +1,93 @@
+/**
+ * @file app_theme.c
+ * Shared constant styles of the watch and an optional minimal theme
+ */
+
+#include "app_theme.h"
+#include "app_conf.h"
+#include "app_font.h"
+#include <string.h>
+
+static const lv_style_const_prop_t screen_props[] = {
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0, 0, 0)),
+    // Opaque and square without the default theme too
+    LV_STYLE_CONST_BG_OPA(LV_OPA_COVER),
+    LV_STYLE_CONST_RADIUS(0),
+    LV_STYLE_CONST_BORDER_WIDTH(0),
+    // The layout is resolved against the full screen (see ui_layout.h)
+    LV_STYLE_CONST_PAD_TOP(0),
+    LV_STYLE_CONST_PAD_BOTTOM(0),
+    LV_STYLE_CONST_PAD_LEFT(0),
+    LV_STYLE_CONST_PAD_RIGHT(0),
+    { .prop = LV_STYLE_PROP_INV },  /*End of the list*/
+};
+static LV_STYLE_CONST_INIT(screen_style, screen_props);
+
+// The fonts of the screens (see app_font.h), as measured by ui_layout.c
+static const lv_style_const_prop_t text_large_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0xFF, 0xFF, 0xFF)),
+    LV_STYLE_CONST_TEXT_FONT(&APP_UI_FONT_WELCOME),
+    { .prop = LV_STYLE_PROP_INV },
+};
+static LV_STYLE_CONST_INIT(text_large_style, text_large_props);
+
+static const lv_style_const_prop_t text_small_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(180, 180, 180)),
+    LV_STYLE_CONST_TEXT_FONT(&APP_UI_FONT_DATE),
+    // Rows as wide as the screen keep any text centered
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_CENTER),
+    { .prop = LV_STYLE_PROP_INV },
+};
+static LV_STYLE_CONST_INIT(text_small_style, text_small_props);
+
+static const lv_style_t *const styles[_APP_THEME_STYLE_CNT] = {
+    [APP_THEME_SCREEN] = &screen_style,
+    [APP_THEME_TEXT_LARGE] = &text_large_style,
+    [APP_THEME_TEXT_SMALL] = &text_small_style,
+};
+
+static lv_theme_t minimal_theme;
+
+static void minimal_apply_cb(lv_theme_t *th, lv_obj_t *obj);
+
+void app_theme_init(lv_disp_t *disp, bool minimal)
+{
+    if (!minimal) return;
+
+    minimal_theme.apply_cb = minimal_apply_cb;
+    minimal_theme.disp = disp;
+    minimal_theme.font_small = LV_FONT_DEFAULT;
+    minimal_theme.font_normal = LV_FONT_DEFAULT;
+    minimal_theme.font_large = LV_FONT_DEFAULT;
+    // Restyles the empty default screen too
+    lv_disp_set_theme(disp, &minimal_theme);
+}
+
+bool app_theme_parse(const char *str, bool *minimal)
+{
+    if (strcmp(str, "default") == 0) {
+        *minimal = false;
+    } else if (strcmp(str, "minimal") == 0) {
+        *minimal = true;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+void app_theme_apply(lv_obj_t *obj, app_theme_style_t style)
+{
+    // LVGL takes non-const styles but never writes constant ones
+    lv_obj_add_style(obj, (lv_style_t *)styles[style], 0);
+}
+
+/**
+ * Only the screens get a style (black background); everything else is styled by the app
+ */
+static void minimal_apply_cb(lv_theme_t *th, lv_obj_t *obj)
+{
+    LV_UNUSED(th);
+
+    if (lv_obj_get_parent(obj) == NULL) app_theme_apply(obj, APP_THEME_SCREEN);
+}
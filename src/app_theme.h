@@ -0,0 +1,49 @@
+/**
+ * @file app_theme.h
+ * Shared constant styles of the watch and an optional minimal theme
+ *
+ * The styles are `LV_STYLE_CONST_INIT` objects: they live in flash, are shared
+ * by every object using them and adding them allocates only the object's
+ * style slot. The minimal theme replaces LVGL's default theme, whose card,
+ * scrollbar, transition and shadow styles the watch never uses but which
+ * every object would carry and every style lookup would walk through.
+ * Both themes render the watch identically.
+ */
+
+#ifndef APP_THEME_H
+#define APP_THEME_H
+
+#include "lvgl/lvgl.h"
+#include <stdbool.h>
+
+typedef enum {
+    APP_THEME_SCREEN,                   /*Black, borderless, unpadded, square container*/
+    APP_THEME_TEXT_LARGE,               /*White large text*/
+    APP_THEME_TEXT_SMALL,               /*Grey small text, centered*/
+    _APP_THEME_STYLE_CNT
+} app_theme_style_t;
+
+/**
+ * Select the theme of a display. Call it right after `lv_disp_drv_register()`,
+ * the objects created before keep the theme they were created with.
+ * @param disp      the display
+ * @param minimal   true: minimal theme (only the screens are styled), false: LVGL's default theme
+ */
+void app_theme_init(lv_disp_t *disp, bool minimal);
+
+/**
+ * Parse a theme name: "default" or "minimal"
+ * @param str       the name
+ * @param minimal   store true for "minimal" here
+ * @return          false if the name is unknown
+ */
+bool app_theme_parse(const char *str, bool *minimal);
+
+/**
+ * Add a shared style to the main part of an object
+ * @param obj       the object
+ * @param style     the style
+ */
+void app_theme_apply(lv_obj_t *obj, app_theme_style_t style);
+
+#endif /*APP_THEME_H*/
@@ -0,0 +1,53 @@
+/**
+ * @file app_tick.c
+ * Millisecond tick source of LVGL
+ */
+
+#include "app_tick.h"
+#include "app_conf.h"
+
+#include <time.h>
+
+#if APP_TICK_SOURCE == APP_TICK_SOURCE_SDL
+#include <SDL2/SDL.h>
+#endif
+
+static uint32_t default_source(void);
+
+static app_tick_source_cb_t source_cb = default_source;
+static volatile uint32_t isr_tick;
+
+uint32_t app_tick_get(void)
+{
+    return source_cb();
+}
+
+void app_tick_set_source(app_tick_source_cb_t cb)
+{
+    source_cb = cb ? cb : default_source;
+}
+
+void app_tick_inc(uint32_t ms)
+{
+    isr_tick += ms;
+}
+
+uint64_t app_tick_get_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static uint32_t default_source(void)
+{
+#if APP_TICK_SOURCE == APP_TICK_SOURCE_MONOTONIC
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000);
+#elif APP_TICK_SOURCE == APP_TICK_SOURCE_SDL
+    return (uint32_t)SDL_GetTicks64();
+#else
+    return isr_tick;
+#endif
+}
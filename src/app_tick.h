@@ -0,0 +1,41 @@
+/**
+ * @file app_tick.h
+ * Millisecond tick source of LVGL (see `LV_TICK_CUSTOM` in lv_conf.h)
+ *
+ * This header is included by lv_conf.h, so it must not include lvgl.h.
+ */
+
+#ifndef APP_TICK_H
+#define APP_TICK_H
+
+#include <stdint.h>
+
+/*Callback returning a free running millisecond counter*/
+typedef uint32_t (*app_tick_source_cb_t)(void);
+
+/**
+ * Get the current tick in milliseconds from the selected source
+ * (`LV_TICK_CUSTOM_SYS_TIME_EXPR`)
+ */
+uint32_t app_tick_get(void);
+
+/**
+ * Replace the tick source, e.g. with the millisecond counter of a hardware timer.
+ * Should be called before `lv_init()`. Pass NULL to restore the default source.
+ */
+void app_tick_set_source(app_tick_source_cb_t cb);
+
+/**
+ * Advance the built-in counter. Call it from a periodic timer interrupt
+ * when no free running counter is available (`APP_TICK_SOURCE_ISR`).
+ * @param ms    milliseconds elapsed since the previous call
+ */
+void app_tick_inc(uint32_t ms);
+
+/**
+ * Get a monotonic timestamp in microseconds for profiling.
+ * It always comes from the host/MCU clock, independently of the tick source.
+ */
+uint64_t app_tick_get_us(void);
+
+#endif /*APP_TICK_H*/
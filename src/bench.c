@@ -0,0 +1,789 @@
+/**
+ * @file bench.c
+ * Headless benchmark of the watch UI
+ *
+ * Renders the loading screen, the switch to the time screen and N clock ticks
+ * into a RAM framebuffer as fast as possible. The LVGL tick and the wall clock
+ * are simulated, so the workload is the same on every run.
+ * The kernels of pixel_conv.h are also timed on the final framebuffer, and
+ * full-screen refreshes and conversions with 1..N render threads (par_render.h).
+ * Finally every available draw backend redraws the loading and the time screen,
+ * and with each rendering tier (see render_tier.h), and the style cost of the
+ * time screen is measured (see app_theme.h).
+ * The results are printed as a JSON object.
+ */
+
+#include "lvgl/lvgl.h"
+#include "app_conf.h"
+#include "app_font.h"
+#include "app_mem.h"
+#include "app_theme.h"
+#include "app_tick.h"
+#include "boot_prof.h"
+#include "draw_backend.h"
+#include "draw_buf.h"
+#include "flush_sched.h"
+#include "mem_display.h"
+#include "par_render.h"
+#include "pixel_conv.h"
+#include "render_tier.h"
+#include "timekeeper.h"
+#include "watch_ui.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define BENCH_CLOCK_TICKS_DEF 60
+#define BENCH_MAX_SAMPLES     4096
+#define BENCH_CONV_FRAMES     200
+#define BENCH_PAR_FRAMES      50
+#define BENCH_DRAW_FRAMES     20
+#define BENCH_STYLE_ROUNDS    1000
+#define BENCH_AOD_MS          (10 * 60 * 1000)    /*Simulated time of the always-on phase*/
+
+// Wall clock at the start of the simulation: 2025-01-01 09:59:30 UTC
+#define BENCH_START_TIME 1735725570
+
+typedef struct {
+    const char *name;
+    uint32_t steps;                     // lv_timer_handler() calls
+    uint32_t frames;                    // refreshes with rendering
+    uint64_t step_us_sum;               // time of all steps
+    uint64_t frame_us_sum;              // time of the steps which rendered
+    uint32_t frame_us[BENCH_MAX_SAMPLES];
+    uint64_t px;                        // refreshed pixels reported by LVGL
+    mem_display_stats_t flush;
+} bench_phase_t;
+
+enum { DRAW_STAT_FILL, DRAW_STAT_BLEND, DRAW_STAT_TEXT, DRAW_STAT_CNT };
+
+typedef struct {
+    uint64_t us;                        // time in the draw callbacks
+    uint64_t px;                        // drawn pixels (fills and blends)
+    uint32_t cnt;                       // calls
+} draw_stat_t;
+
+static uint32_t sim_tick;
+static uint32_t frame_px;
+static bool frame_rendered;
+
+static draw_stat_t draw_stats[DRAW_STAT_CNT];
+static void (*user_draw_rect)(lv_draw_ctx_t *, const lv_draw_rect_dsc_t *, const lv_area_t *);
+static void (*user_draw_img_decoded)(lv_draw_ctx_t *, const lv_draw_img_dsc_t *, const lv_area_t *,
+                                     const uint8_t *, lv_img_cf_t);
+static void (*user_draw_letter)(lv_draw_ctx_t *, const lv_draw_label_dsc_t *, const lv_point_t *, uint32_t);
+
+static uint32_t sim_tick_get(void);
+static int64_t sim_time_get(void);
+#if APP_FLUSH_SCHED
+static lv_coord_t sim_scan_line_get(void);
+#endif
+static void bench_monitor_cb(lv_disp_drv_t *drv, uint32_t time, uint32_t px);
+static void phase_begin(bench_phase_t *phase, const char *name);
+static uint32_t phase_step(bench_phase_t *phase, uint32_t advance_ms);
+static void phase_end(bench_phase_t *phase);
+static void phase_print(FILE *out, const bench_phase_t *phase, bool last);
+#if APP_AOD
+static void aod_print(FILE *out, const bench_phase_t *phase, uint32_t sim_ms);
+#endif
+static void conv_print(FILE *out);
+#if APP_PAR_RENDER
+static void par_print(FILE *out);
+static void par_conv_band(void *user_data, uint32_t idx, uint32_t cnt);
+#endif
+static void draw_timing_attach(lv_disp_t *disp);
+static void timed_draw_rect(lv_draw_ctx_t *draw_ctx, const lv_draw_rect_dsc_t *dsc, const lv_area_t *coords);
+static void timed_draw_img_decoded(lv_draw_ctx_t *draw_ctx, const lv_draw_img_dsc_t *dsc, const lv_area_t *coords,
+                                   const uint8_t *map_p, lv_img_cf_t cf);
+static void timed_draw_letter(lv_draw_ctx_t *draw_ctx, const lv_draw_label_dsc_t *dsc, const lv_point_t *pos_p,
+                              uint32_t letter);
+static void draw_stat_add(draw_stat_t *stat, uint64_t start, const lv_draw_ctx_t *draw_ctx, const lv_area_t *coords);
+static void draw_screen_print(FILE *out, const char *name, bool last);
+static void draw_print(FILE *out, lv_disp_t *disp, draw_backend_t active, render_tier_t tier);
+static void tier_print(FILE *out, lv_disp_t *disp, draw_backend_t backend, render_tier_t active);
+static uint32_t font_bpp(const lv_font_t *font);
+static void style_print(FILE *out, bool minimal, uint32_t ui_heap);
+static void style_count(lv_obj_t *obj, uint32_t *objs, uint32_t *styles);
+static void style_resolve(lv_obj_t *obj);
+static uint32_t mem_used(void);
+static int cmp_u32(const void *a, const void *b);
+
+int main(int argc, char **argv)
+{
+    draw_buf_mode_t buf_mode = APP_DRAW_BUF_MODE;
+    uint32_t buf_lines = APP_DRAW_BUF_LINES;
+    draw_backend_t backend = APP_DRAW_BACKEND;
+    bool minimal_theme = APP_THEME_MINIMAL;
+    render_tier_t tier = APP_RENDER_TIER;
+    uint32_t clock_ticks = BENCH_CLOCK_TICKS_DEF;
+    const char *json_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--buf=", 6) == 0 && draw_buf_parse(argv[i] + 6, &buf_mode, &buf_lines)) {
+            continue;
+        }
+        if (strncmp(argv[i], "--draw=", 7) == 0 && draw_backend_parse(argv[i] + 7, &backend)) {
+            continue;
+        }
+        if (strncmp(argv[i], "--theme=", 8) == 0 && app_theme_parse(argv[i] + 8, &minimal_theme)) {
+            continue;
+        }
+        if (strncmp(argv[i], "--render=", 9) == 0 && render_tier_parse(argv[i] + 9, &tier)) {
+            continue;
+        }
+        if (strncmp(argv[i], "--ticks=", 8) == 0 && atoi(argv[i] + 8) > 0) {
+            clock_ticks = (uint32_t)atoi(argv[i] + 8);
+            continue;
+        }
+        if (strncmp(argv[i], "--json=", 7) == 0) {
+            json_path = argv[i] + 7;
+            continue;
+        }
+        printf("Usage: %s [--buf=partial[:lines]|full|full-refresh|direct|direct-fb] [--draw=auto|sw|sw-bands|dma2d|arm2d|pxp] [--theme=default|minimal] [--render=full|fast] [--ticks=N] [--json=file]\n", argv[0]);
+        return 1;
+    }
+
+    // Same local time on every host
+    setenv("TZ", "UTC", 1);
+    tzset();
+
+    app_tick_set_source(sim_tick_get);
+    timekeeper_set_rtc(sim_time_get);
+
+    boot_prof_mark("start");
+    lv_init();
+    boot_prof_mark("lv_init");
+
+    if (!mem_display_init(SCREEN_WIDTH, SCREEN_HEIGHT)) {
+        printf("Can't allocate the framebuffer\n");
+        return 1;
+    }
+
+    draw_buf_set_panel_fb(mem_display_get_fb());
+
+#if APP_PAR_RENDER
+    par_render_init(APP_PAR_RENDER_THREADS);
+#endif
+
+    static lv_disp_drv_t disp_drv;
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.flush_cb = mem_display_flush;
+    backend = draw_backend_setup(&disp_drv, backend);
+    disp_drv.hor_res = SCREEN_WIDTH;
+    disp_drv.ver_res = SCREEN_HEIGHT;
+    if (!draw_buf_setup(&disp_drv, buf_mode, buf_lines)) {
+        return 1;
+    }
+    disp_drv.monitor_cb = bench_monitor_cb;
+    lv_disp_t *disp = lv_disp_drv_register(&disp_drv);
+    app_theme_init(disp, minimal_theme);
+    render_tier_setup(disp, tier);
+    boot_prof_mark("display driver");
+#if APP_FLUSH_SCHED
+    flush_sched_attach(disp);
+    // The scan line follows the simulated tick too
+    flush_sched_set_scan_line_cb(sim_scan_line_get);
+#endif
+
+    static bench_phase_t boot, loading, swap, clock;
+#if APP_AOD
+    static bench_phase_t aod;
+    uint32_t aod_ms = 0;
+
+    // The clock phase measures the ticking seconds, the always-on mode has its own phase
+    watch_ui_set_aod_enabled(false);
+#endif
+
+    // Build the loading screen and render the first frame
+    uint32_t mem_before_ui = mem_used();
+    phase_begin(&boot, "boot");
+    uint64_t create_start = app_tick_get_us();
+    watch_ui_create();
+    uint64_t create_us = app_tick_get_us() - create_start;
+    boot_prof_mark("loading screen");
+    phase_step(&boot, 0);
+    boot_prof_first_pixel();
+    phase_end(&boot);
+
+    // Static loading screen (the time screen is prebuilt meanwhile)
+    phase_begin(&loading, "loading");
+    while (sim_tick + LV_DISP_DEF_REFR_PERIOD < 4000) {
+        phase_step(&loading, LV_DISP_DEF_REFR_PERIOD);
+    }
+    phase_end(&loading);
+
+    // The loading timer fires and the time screen is shown
+    phase_begin(&swap, "swap");
+    phase_step(&swap, 4000 - sim_tick);
+    phase_end(&swap);
+
+    phase_begin(&clock, "clock");
+    for (uint32_t i = 0; i < clock_ticks; i++) {
+        phase_step(&clock, 1000);
+    }
+    phase_end(&clock);
+    uint32_t ui_heap = mem_used() - mem_before_ui;
+
+#if APP_AOD
+    // No input since the start: the mode is entered right away. The steps follow the
+    // timers, as the main loop sleeps until the next one is due.
+    watch_ui_set_aod_enabled(true);
+    phase_begin(&aod, "aod");
+    uint32_t next_ms = 0;
+    while (aod_ms < BENCH_AOD_MS) {
+        aod_ms += next_ms;
+        next_ms = phase_step(&aod, next_ms);
+        if (next_ms == 0) next_ms = 1;
+        if (next_ms > BENCH_AOD_MS) next_ms = BENCH_AOD_MS;
+    }
+    phase_end(&aod);
+    // The backend and tier comparisons draw the time screen with the seconds
+    watch_ui_set_aod_enabled(false);
+#endif
+
+#if APP_MEM_CUSTOM
+    app_mem_stats_t mem;
+    app_mem_get_stats(&mem);
+#else
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+#endif
+
+    FILE *out = stdout;
+    if (json_path) {
+        out = fopen(json_path, "w");
+        if (!out) {
+            printf("Can't open %s\n", json_path);
+            return 1;
+        }
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"resolution\": [%d, %d],\n", SCREEN_WIDTH, SCREEN_HEIGHT);
+    fprintf(out, "  \"buf_mode\": \"%s\",\n", draw_buf_mode_name(buf_mode));
+    fprintf(out, "  \"draw_backend\": \"%s\",\n", draw_backend_name(backend));
+    fprintf(out, "  \"render_tier\": \"%s\",\n", render_tier_name(tier));
+    fprintf(out, "  \"buf_lines\": %u,\n", (unsigned)(buf_mode == DRAW_BUF_PARTIAL ? buf_lines : SCREEN_HEIGHT));
+    fprintf(out, "  \"clock_ticks\": %u,\n", (unsigned)clock_ticks);
+    fprintf(out, "  \"ui_create_us\": %llu,\n", (unsigned long long)create_us);
+#if APP_BOOT_PROF
+    const boot_prof_mark_t *marks;
+    uint32_t mark_cnt = boot_prof_get_marks(&marks);
+    fprintf(out, "  \"boot\": { \"first_pixel_us\": %llu, \"budget_ms\": %u, \"phases\": [",
+            (unsigned long long)boot_prof_get_first_pixel_us(), (unsigned)APP_BOOT_BUDGET_MS);
+    for(uint32_t i = 1; i < mark_cnt; i++) {
+        fprintf(out, "%s{ \"name\": \"%s\", \"us\": %llu }", i > 1 ? ", " : "", marks[i].name,
+                (unsigned long long)(marks[i].us - marks[i - 1].us));
+    }
+    fprintf(out, "] },\n");
+#endif
+    fprintf(out, "  \"phases\": [\n");
+    phase_print(out, &boot, false);
+    phase_print(out, &loading, false);
+    phase_print(out, &swap, false);
+    phase_print(out, &clock, true);
+    fprintf(out, "  ],\n");
+#if APP_AOD
+    aod_print(out, &aod, aod_ms);
+#endif
+    conv_print(out);
+#if APP_PAR_RENDER
+    par_print(out);
+#endif
+    draw_print(out, disp, backend, tier);
+    tier_print(out, disp, backend, tier);
+    style_print(out, minimal_theme, ui_heap);
+#if APP_MEM_CUSTOM
+    fprintf(out, "  \"mem\": { \"allocator\": \"app_mem\", \"max_used\": %u, \"used\": %u, \"frag_pct\": %u, "
+                 "\"arena_used\": %u, \"heap_used\": %u, \"classes\": [",
+            (unsigned)mem.peak, (unsigned)mem.used, (unsigned)mem.frag_pct,
+            (unsigned)mem.arena_used, (unsigned)mem.heap_used);
+    for(int c = 0; c < APP_MEM_CLASS_CNT; c++) {
+        fprintf(out, "%s{ \"size\": %u, \"peak\": %u, \"allocs\": %u, \"to_heap\": %u }", c ? ", " : "",
+                (unsigned)mem.classes[c].block_size, (unsigned)mem.classes[c].peak,
+                (unsigned)mem.classes[c].alloc_cnt, (unsigned)mem.classes[c].fallback_cnt);
+    }
+    fprintf(out, "] }\n");
+#else
+    fprintf(out, "  \"mem\": { \"allocator\": \"lv_mem\", \"total\": %u, \"max_used\": %u, \"used\": %u, \"frag_pct\": %u }\n",
+            (unsigned)mon.total_size, (unsigned)mon.max_used,
+            (unsigned)(mon.total_size - mon.free_size), (unsigned)mon.frag_pct);
+#endif
+    fprintf(out, "}\n");
+
+    if (out != stdout) fclose(out);
+    mem_display_deinit();
+#if APP_PAR_RENDER
+    par_render_deinit();
+#endif
+
+    return 0;
+}
+
+/**
+ * Simulated LVGL tick
+ */
+static uint32_t sim_tick_get(void)
+{
+    return sim_tick;
+}
+
+/**
+ * Simulated wall clock, advancing with the LVGL tick
+ */
+static int64_t sim_time_get(void)
+{
+    return (int64_t)BENCH_START_TIME * 1000 + sim_tick;
+}
+
+#if APP_FLUSH_SCHED
+/**
+ * Scan line of a simulated 60 Hz panel
+ */
+static lv_coord_t sim_scan_line_get(void)
+{
+    return (lv_coord_t)((sim_tick * 60 % 1000) * SCREEN_HEIGHT / 1000);
+}
+#endif
+
+/**
+ * Called by LVGL after every refresh
+ */
+static void bench_monitor_cb(lv_disp_drv_t *drv, uint32_t time, uint32_t px)
+{
+    LV_UNUSED(drv);
+    LV_UNUSED(time);
+
+    frame_rendered = true;
+    frame_px += px;
+}
+
+static void phase_begin(bench_phase_t *phase, const char *name)
+{
+    memset(phase, 0, sizeof(*phase));
+    phase->name = name;
+    mem_display_reset_stats();
+}
+
+/**
+ * Advance the simulated time and let LVGL run the due timers and render
+ * @return          time until the next timer is due, as `lv_timer_handler()` tells [ms]
+ */
+static uint32_t phase_step(bench_phase_t *phase, uint32_t advance_ms)
+{
+    sim_tick += advance_ms;
+    frame_rendered = false;
+    frame_px = 0;
+
+    uint64_t start = app_tick_get_us();
+    uint32_t idle_ms = lv_timer_handler();
+    // Render now if the refresh timer wasn't due in this call
+    lv_refr_now(NULL);
+    uint32_t elapsed = (uint32_t)(app_tick_get_us() - start);
+
+    phase->steps++;
+    phase->step_us_sum += elapsed;
+    if (!frame_rendered) return idle_ms;
+
+    if (phase->frames < BENCH_MAX_SAMPLES) phase->frame_us[phase->frames] = elapsed;
+    phase->frames++;
+    phase->frame_us_sum += elapsed;
+    phase->px += frame_px;
+
+    return idle_ms;
+}
+
+static void phase_end(bench_phase_t *phase)
+{
+    phase->flush = mem_display_get_stats();
+}
+
+static void phase_print(FILE *out, const bench_phase_t *phase, bool last)
+{
+    uint32_t sample_cnt = phase->frames < BENCH_MAX_SAMPLES ? phase->frames : BENCH_MAX_SAMPLES;
+    uint32_t sorted[BENCH_MAX_SAMPLES];
+    uint32_t p99 = 0;
+
+    if (sample_cnt > 0) {
+        memcpy(sorted, phase->frame_us, sample_cnt * sizeof(uint32_t));
+        qsort(sorted, sample_cnt, sizeof(uint32_t), cmp_u32);
+        p99 = sorted[(sample_cnt * 99 + 99) / 100 - 1];
+    }
+
+    double avg_us = phase->frames ? (double)phase->frame_us_sum / phase->frames : 0.0;
+    double fps = phase->frame_us_sum ? (double)phase->frames * 1000000.0 / (double)phase->frame_us_sum : 0.0;
+
+    fprintf(out, "    { \"name\": \"%s\", \"steps\": %u, \"frames\": %u, \"fps\": %.1f, "
+                 "\"avg_render_us\": %.1f, \"p99_render_us\": %u, \"avg_step_us\": %.1f, "
+                 "\"px\": %llu, \"flushes\": %u, \"flush_bytes\": %llu }%s\n",
+            phase->name, (unsigned)phase->steps, (unsigned)phase->frames, fps,
+            avg_us, (unsigned)p99, phase->steps ? (double)phase->step_us_sum / phase->steps : 0.0,
+            (unsigned long long)phase->px, (unsigned)phase->flush.flush_cnt,
+            (unsigned long long)phase->flush.flush_bytes, last ? "" : ",");
+}
+
+#if APP_AOD
+/**
+ * Print the always-on phase with the power proxy of telemetry.h: pixels sent to the
+ * panel and wakeups (`lv_timer_handler()` calls), extrapolated to an hour
+ */
+static void aod_print(FILE *out, const bench_phase_t *phase, uint32_t sim_ms)
+{
+    uint64_t sent_px = phase->flush.flush_bytes / sizeof(lv_color_t);
+    uint32_t ms = sim_ms ? sim_ms : 1;
+
+    fprintf(out, "  \"aod\": { \"sim_ms\": %u, \"steps\": %u, \"frames\": %u, \"px_per_hour\": %llu, "
+                 "\"wakeups_per_hour\": %u, \"avg_render_us\": %.1f },\n",
+            (unsigned)sim_ms, (unsigned)phase->steps, (unsigned)phase->frames,
+            (unsigned long long)(sent_px * 3600000 / ms), (unsigned)((uint64_t)phase->steps * 3600000 / ms),
+            phase->frames ? (double)phase->frame_us_sum / phase->frames : 0.0);
+}
+#endif
+
+/**
+ * Convert the framebuffer row by row (as a flush does) with every pixel
+ * conversion kernel and print their throughput
+ */
+static void conv_print(FILE *out)
+{
+    uint32_t px_cnt = (uint32_t)SCREEN_WIDTH * SCREEN_HEIGHT;
+    const uint16_t *fb = (const uint16_t *)mem_display_get_fb();
+    uint32_t *ref = malloc(px_cnt * sizeof(uint32_t));
+    uint32_t *dst = malloc(px_cnt * sizeof(uint32_t));
+    uint32_t impl_cnt;
+    const pixel_conv_impl_t *impls = pixel_conv_get_impls(&impl_cnt);
+
+    fprintf(out, "  \"pixel_conv\": { \"selected\": \"%s\", \"kernels\": [", pixel_conv_get_impl()->name);
+    if (!ref || !dst) impl_cnt = 0;
+
+    for(uint32_t i = 0; i < impl_cnt; i++) {
+        uint64_t start = app_tick_get_us();
+        for(uint32_t f = 0; f < BENCH_CONV_FRAMES; f++) {
+            for(uint32_t y = 0; y < SCREEN_HEIGHT; y++) {
+                impls[i].cb(dst + y * SCREEN_WIDTH, fb + y * SCREEN_WIDTH, SCREEN_WIDTH);
+            }
+        }
+        uint64_t elapsed = app_tick_get_us() - start;
+
+        // Every kernel has to match the scalar one
+        if (i == 0) memcpy(ref, dst, px_cnt * sizeof(uint32_t));
+        bool exact = memcmp(ref, dst, px_cnt * sizeof(uint32_t)) == 0;
+
+        double mpix_s = elapsed ? (double)px_cnt * BENCH_CONV_FRAMES / (double)elapsed : 0.0;
+        fprintf(out, "%s\n    { \"name\": \"%s\", \"mpix_s\": %.1f, \"exact\": %s }",
+                i ? "," : "", impls[i].name, mpix_s, exact ? "true" : "false");
+    }
+    fprintf(out, "\n  ] },\n");
+
+    free(ref);
+    free(dst);
+}
+
+#if APP_PAR_RENDER
+/**
+ * Time full-screen refreshes and conversions of the framebuffer in bands
+ * with 1, 2, 4 ... render threads up to the number of CPUs
+ */
+static void par_print(FILE *out)
+{
+    uint32_t px_cnt = (uint32_t)SCREEN_WIDTH * SCREEN_HEIGHT;
+    uint32_t *dst = malloc(px_cnt * sizeof(uint32_t));
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t max_threads = cpus > 0 ? (uint32_t)cpus : 1;
+    uint64_t base_frame_us = 0;
+    uint64_t base_conv_us = 0;
+
+    if (max_threads > APP_PAR_RENDER_MAX_THREADS) max_threads = APP_PAR_RENDER_MAX_THREADS;
+    fprintf(out, "  \"parallel\": { \"cpus\": %ld, \"runs\": [", cpus);
+
+    for(uint32_t t = 1; t <= max_threads && dst; t = (t * 2 > max_threads && t < max_threads) ? max_threads : t * 2) {
+        par_render_deinit();
+        if (!par_render_init(t)) break;
+
+        uint64_t start = app_tick_get_us();
+        for(uint32_t f = 0; f < BENCH_PAR_FRAMES; f++) {
+            lv_obj_invalidate(lv_scr_act());
+            lv_refr_now(NULL);
+        }
+        uint64_t frame_us = (app_tick_get_us() - start) / BENCH_PAR_FRAMES;
+
+        start = app_tick_get_us();
+        for(uint32_t f = 0; f < BENCH_CONV_FRAMES; f++) {
+            par_render_run(par_conv_band, dst, t);
+        }
+        uint64_t conv_us = (app_tick_get_us() - start) / BENCH_CONV_FRAMES;
+
+        if (t == 1) {
+            base_frame_us = frame_us;
+            base_conv_us = conv_us;
+        }
+        fprintf(out, "%s\n    { \"threads\": %u, \"frame_us\": %llu, \"frame_speedup\": %.2f, "
+                     "\"conv_us\": %llu, \"conv_speedup\": %.2f }",
+                t > 1 ? "," : "", (unsigned)t, (unsigned long long)frame_us,
+                frame_us ? (double)base_frame_us / (double)frame_us : 0.0,
+                (unsigned long long)conv_us, conv_us ? (double)base_conv_us / (double)conv_us : 0.0);
+    }
+    fprintf(out, "\n  ] },\n");
+
+    par_render_deinit();
+    free(dst);
+}
+
+/**
+ * Convert band `idx` of `cnt` of the framebuffer
+ */
+static void par_conv_band(void *user_data, uint32_t idx, uint32_t cnt)
+{
+    uint32_t *dst = user_data;
+    const uint16_t *fb = (const uint16_t *)mem_display_get_fb();
+    uint32_t y1 = SCREEN_HEIGHT * idx / cnt;
+    uint32_t y2 = SCREEN_HEIGHT * (idx + 1) / cnt;
+
+    for(uint32_t y = y1; y < y2; y++) {
+        pixel_conv_rgb565_to_argb8888(dst + y * SCREEN_WIDTH, fb + y * SCREEN_WIDTH, SCREEN_WIDTH);
+    }
+}
+#endif
+
+/**
+ * Replace the draw callbacks of the display's draw context with timed ones
+ */
+static void draw_timing_attach(lv_disp_t *disp)
+{
+    lv_draw_ctx_t *draw_ctx = disp->driver->draw_ctx;
+
+    user_draw_rect = draw_ctx->draw_rect;
+    user_draw_img_decoded = draw_ctx->draw_img_decoded;
+    user_draw_letter = draw_ctx->draw_letter;
+    draw_ctx->draw_rect = timed_draw_rect;
+    draw_ctx->draw_img_decoded = timed_draw_img_decoded;
+    draw_ctx->draw_letter = timed_draw_letter;
+}
+
+static void timed_draw_rect(lv_draw_ctx_t *draw_ctx, const lv_draw_rect_dsc_t *dsc, const lv_area_t *coords)
+{
+    uint64_t start = app_tick_get_us();
+    user_draw_rect(draw_ctx, dsc, coords);
+    draw_stat_add(&draw_stats[DRAW_STAT_FILL], start, draw_ctx, coords);
+}
+
+static void timed_draw_img_decoded(lv_draw_ctx_t *draw_ctx, const lv_draw_img_dsc_t *dsc, const lv_area_t *coords,
+                                   const uint8_t *map_p, lv_img_cf_t cf)
+{
+    uint64_t start = app_tick_get_us();
+    user_draw_img_decoded(draw_ctx, dsc, coords, map_p, cf);
+    draw_stat_add(&draw_stats[DRAW_STAT_BLEND], start, draw_ctx, coords);
+}
+
+static void timed_draw_letter(lv_draw_ctx_t *draw_ctx, const lv_draw_label_dsc_t *dsc, const lv_point_t *pos_p,
+                              uint32_t letter)
+{
+    uint64_t start = app_tick_get_us();
+    user_draw_letter(draw_ctx, dsc, pos_p, letter);
+    draw_stat_add(&draw_stats[DRAW_STAT_TEXT], start, draw_ctx, NULL);
+}
+
+/**
+ * Account a draw call, with the drawn pixels (the area clipped to the draw context) if `coords` is set
+ */
+static void draw_stat_add(draw_stat_t *stat, uint64_t start, const lv_draw_ctx_t *draw_ctx, const lv_area_t *coords)
+{
+    lv_area_t clipped;
+
+    stat->us += app_tick_get_us() - start;
+    stat->cnt++;
+    if (coords && _lv_area_intersect(&clipped, coords, draw_ctx->clip_area)) {
+        stat->px += lv_area_get_size(&clipped);
+    }
+}
+
+/**
+ * Redraw a screen with the current backend and print the time of the
+ * fills (rectangles), blends (images, e.g. the glyph cache) and text
+ */
+static void draw_screen_print(FILE *out, const char *name, bool last)
+{
+    memset(draw_stats, 0, sizeof(draw_stats));
+
+    uint64_t start = app_tick_get_us();
+    for(uint32_t f = 0; f < BENCH_DRAW_FRAMES; f++) {
+        lv_obj_invalidate(lv_scr_act());
+        lv_refr_now(NULL);
+    }
+    uint64_t frame_us = (app_tick_get_us() - start) / BENCH_DRAW_FRAMES;
+
+    const draw_stat_t *fill = &draw_stats[DRAW_STAT_FILL];
+    const draw_stat_t *blend = &draw_stats[DRAW_STAT_BLEND];
+    const draw_stat_t *text = &draw_stats[DRAW_STAT_TEXT];
+    fprintf(out, "{ \"name\": \"%s\", \"frame_us\": %llu, \"fill_mpx_s\": %.1f, \"blend_mpx_s\": %.1f, "
+                 "\"glyphs_per_s\": %.0f }%s",
+            name, (unsigned long long)frame_us,
+            fill->us ? (double)fill->px / (double)fill->us : 0.0,
+            blend->us ? (double)blend->px / (double)blend->us : 0.0,
+            text->us ? (double)text->cnt * 1000000.0 / (double)text->us : 0.0, last ? "" : ", ");
+}
+
+/**
+ * Compare the available draw backends on the loading and the time screen
+ */
+static void draw_print(FILE *out, lv_disp_t *disp, draw_backend_t active, render_tier_t tier)
+{
+    bool first = true;
+
+    fprintf(out, "  \"draw_backends\": [");
+    for(int b = DRAW_BACKEND_SW; b < _DRAW_BACKEND_CNT; b++) {
+        if (!draw_backend_switch(disp, (draw_backend_t)b)) continue;
+        render_tier_setup(disp, tier);
+        draw_timing_attach(disp);
+
+        fprintf(out, "%s\n    { \"name\": \"%s\", \"screens\": [", first ? "" : ",", draw_backend_name((draw_backend_t)b));
+        first = false;
+
+        // The loading screen is gone, rebuild its content over the time screen
+        lv_obj_t *cont = lv_obj_create(lv_scr_act());
+        lv_obj_set_size(cont, lv_pct(100), lv_pct(100));
+        watch_ui_create_splash(cont);
+        draw_screen_print(out, "loading", false);
+        lv_obj_del(cont);
+
+        draw_screen_print(out, "time", true);
+        fprintf(out, "] }");
+    }
+    fprintf(out, "\n  ],\n");
+
+    draw_backend_switch(disp, active);
+    render_tier_setup(disp, tier);
+}
+
+/**
+ * Compare the rendering tiers on the loading and the time screen with the active backend.
+ * The reduced-bpp tier is a build option, so the bpp of the fonts is printed too.
+ */
+static void tier_print(FILE *out, lv_disp_t *disp, draw_backend_t backend, render_tier_t active)
+{
+    bool first = true;
+
+    fprintf(out, "  \"render_tiers\": { \"font_bpp\": %u, \"clock_font_bpp\": %u, \"tiers\": [",
+            (unsigned)font_bpp(&APP_UI_FONT_DATE), (unsigned)font_bpp(&APP_UI_FONT_CLOCK));
+    for(int t = 0; t < _RENDER_TIER_CNT; t++) {
+        // A fresh context each time, so the wrappers don't stack
+        if (!draw_backend_switch(disp, backend)) break;
+        render_tier_setup(disp, (render_tier_t)t);
+        draw_timing_attach(disp);
+        render_tier_reset_stats();
+
+        fprintf(out, "%s\n    { \"name\": \"%s\", \"screens\": [", first ? "" : ",", render_tier_name((render_tier_t)t));
+        first = false;
+
+        // Created as screen_mgr does, styled and watched like the real loading screen
+        lv_obj_t *cont = lv_obj_create(lv_scr_act());
+        lv_obj_set_size(cont, lv_pct(100), lv_pct(100));
+        watch_ui_create_splash(cont);
+        draw_screen_print(out, "loading", false);
+        lv_obj_del(cont);
+
+        draw_screen_print(out, "time", true);
+
+        render_tier_stats_t stats;
+        render_tier_get_stats(&stats);
+        // Pixels of fast glyphs over other ink are still blended, only the table writes are saved
+        uint32_t glyphs = stats.fast + stats.blended;
+        uint32_t px = stats.lut_px + stats.mixed_px;
+        fprintf(out, "], \"fast_glyphs_pct\": %u, \"lut_px\": %u, \"mixed_px\": %u, \"lut_px_pct\": %u }",
+                (unsigned)(glyphs ? stats.fast * 100 / glyphs : 0), (unsigned)stats.lut_px, (unsigned)stats.mixed_px,
+                (unsigned)(px ? (uint64_t)stats.lut_px * 100 / px : 0));
+    }
+    fprintf(out, "\n  ] },\n");
+
+    draw_backend_switch(disp, backend);
+    render_tier_setup(disp, active);
+}
+
+/**
+ * Get the bpp of a font, 0 if it isn't in LVGL's font format
+ */
+static uint32_t font_bpp(const lv_font_t *font)
+{
+    if (font->get_glyph_bitmap != lv_font_get_bitmap_fmt_txt) return 0;
+
+    return ((const lv_font_fmt_txt_dsc_t *)font->dsc)->bpp;
+}
+
+/**
+ * Print the style cost of the active screen: the style slots of its objects,
+ * the time to resolve the draw descriptors of all of them (what every full
+ * refresh does) and the heap taken by the UI
+ */
+static void style_print(FILE *out, bool minimal, uint32_t ui_heap)
+{
+    uint32_t objs = 0;
+    uint32_t styles = 0;
+    style_count(lv_scr_act(), &objs, &styles);
+
+    uint64_t start = app_tick_get_us();
+    for(uint32_t r = 0; r < BENCH_STYLE_ROUNDS; r++) {
+        style_resolve(lv_scr_act());
+    }
+    double resolve_us = (double)(app_tick_get_us() - start) / BENCH_STYLE_ROUNDS;
+
+    fprintf(out, "  \"styles\": { \"theme\": \"%s\", \"objs\": %u, \"style_slots\": %u, "
+                 "\"resolve_us_per_refresh\": %.2f, \"ui_heap\": %u },\n",
+            minimal ? "minimal" : "default", (unsigned)objs, (unsigned)styles, resolve_us, (unsigned)ui_heap);
+}
+
+static void style_count(lv_obj_t *obj, uint32_t *objs, uint32_t *styles)
+{
+    (*objs)++;
+    *styles += obj->style_cnt;
+
+    uint32_t cnt = lv_obj_get_child_cnt(obj);
+    for(uint32_t i = 0; i < cnt; i++) {
+        style_count(lv_obj_get_child(obj, (int32_t)i), objs, styles);
+    }
+}
+
+/**
+ * Resolve the draw descriptors of a tree as the draw events would
+ */
+static void style_resolve(lv_obj_t *obj)
+{
+    lv_draw_rect_dsc_t rect_dsc;
+    lv_draw_rect_dsc_init(&rect_dsc);
+    lv_obj_init_draw_rect_dsc(obj, LV_PART_MAIN, &rect_dsc);
+
+    if (lv_obj_check_type(obj, &lv_label_class)) {
+        lv_draw_label_dsc_t label_dsc;
+        lv_draw_label_dsc_init(&label_dsc);
+        lv_obj_init_draw_label_dsc(obj, LV_PART_MAIN, &label_dsc);
+    }
+
+    uint32_t cnt = lv_obj_get_child_cnt(obj);
+    for(uint32_t i = 0; i < cnt; i++) {
+        style_resolve(lv_obj_get_child(obj, (int32_t)i));
+    }
+}
+
+/**
+ * Bytes allocated by LVGL now
+ */
+static uint32_t mem_used(void)
+{
+#if APP_MEM_CUSTOM
+    app_mem_stats_t mem;
+    app_mem_get_stats(&mem);
+    return mem.used;
+#else
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+#endif
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t va = *(const uint32_t *)a;
+    uint32_t vb = *(const uint32_t *)b;
+
+    return (va > vb) - (va < vb);
+}
@@ -0,0 +1,65 @@
+/**
+ * @file boot_prof.c
+ * Boot phase profiler
+ */
+
+#include "boot_prof.h"
+
+#if APP_BOOT_PROF
+
+#include "app_tick.h"
+#include <stdio.h>
+
+#define MAX_MARKS 16
+
+static boot_prof_mark_t marks[MAX_MARKS];
+static uint32_t mark_cnt;
+static uint64_t start_us;
+static uint64_t first_pixel_us;
+
+void boot_prof_mark(const char *name)
+{
+    uint64_t now = app_tick_get_us();
+
+    if (mark_cnt == 0) start_us = now;
+    if (mark_cnt >= MAX_MARKS) return;
+
+    marks[mark_cnt].name = name;
+    marks[mark_cnt].us = now - start_us;
+    mark_cnt++;
+}
+
+void boot_prof_first_pixel(void)
+{
+    boot_prof_mark("first pixel");
+    first_pixel_us = marks[mark_cnt - 1].us;
+}
+
+uint32_t boot_prof_get_marks(const boot_prof_mark_t **m)
+{
+    *m = marks;
+
+    return mark_cnt;
+}
+
+uint64_t boot_prof_get_first_pixel_us(void)
+{
+    return first_pixel_us;
+}
+
+void boot_prof_report(void)
+{
+    printf("[boot] %-20s %10s %10s\n", "phase", "took [ms]", "at [ms]");
+    for(uint32_t i = 1; i < mark_cnt; i++) {
+        printf("[boot] %-20s %10.2f %10.2f\n", marks[i].name,
+               (double)(marks[i].us - marks[i - 1].us) / 1000.0, (double)marks[i].us / 1000.0);
+    }
+
+    if (first_pixel_us == 0) return;
+
+    double ttfp_ms = (double)first_pixel_us / 1000.0;
+    printf("[boot] time to first pixel: %.2f ms (budget %u ms%s)\n", ttfp_ms, (unsigned)APP_BOOT_BUDGET_MS,
+           ttfp_ms > APP_BOOT_BUDGET_MS ? ", EXCEEDED" : "");
+}
+
+#endif /*APP_BOOT_PROF*/
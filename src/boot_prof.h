@@ -0,0 +1,68 @@
+/**
+ * @file boot_prof.h
+ * Boot phase profiler
+ *
+ * `main()` marks the end of every startup phase; the report lists the phases
+ * with their duration and the time to the first presented frame, checked
+ * against `APP_BOOT_BUDGET_MS`. The time is counted from the first mark.
+ */
+
+#ifndef BOOT_PROF_H
+#define BOOT_PROF_H
+
+#include "app_conf.h"
+#include <stdint.h>
+
+typedef struct {
+    const char *name;
+    uint64_t us;            /*Time since the first mark*/
+} boot_prof_mark_t;
+
+#if APP_BOOT_PROF
+
+/**
+ * Timestamp the end of a phase (the first call starts the clock)
+ * @param name      name of the phase (static string)
+ */
+void boot_prof_mark(const char *name);
+
+/**
+ * Mark that the first frame is on the screen
+ */
+void boot_prof_first_pixel(void);
+
+/**
+ * Get the marks recorded so far
+ * @param marks     store the array here
+ * @return          number of marks
+ */
+uint32_t boot_prof_get_marks(const boot_prof_mark_t **marks);
+
+/**
+ * Get the time to the first pixel [us], 0 if it isn't marked yet
+ */
+uint64_t boot_prof_get_first_pixel_us(void);
+
+/**
+ * Print the startup report to stdout
+ */
+void boot_prof_report(void);
+
+#else
+
+static inline void boot_prof_mark(const char *name)
+{
+    (void)name;
+}
+
+static inline void boot_prof_first_pixel(void)
+{
+}
+
+static inline void boot_prof_report(void)
+{
+}
+
+#endif /*APP_BOOT_PROF*/
+
+#endif /*BOOT_PROF_H*/
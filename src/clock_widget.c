@@ -0,0 +1,134 @@
+/**
+ * @file clock_widget.c
+ * "HH:MM:SS" clock made of fixed width cells
+ */
+
+#include "clock_widget.h"
+
+static lv_coord_t get_max_glyph_width(const lv_font_t *font, const char *chars);
+static void create_cell(clock_widget_t *clock, int i, char c);
+static void set_cell_char(clock_widget_t *clock, int i, char c);
+
+lv_obj_t *clock_widget_create(clock_widget_t *clock, lv_obj_t *parent, const lv_font_t *font, lv_color_t color)
+{
+    // Digits are proportional in most fonts, so every digit cell gets the width of the widest one
+    lv_coord_t digit_w = get_max_glyph_width(font, CLOCK_WIDGET_DIGITS);
+    lv_coord_t colon_w = get_max_glyph_width(font, ":");
+    lv_coord_t h = lv_font_get_line_height(font);
+
+    // Plain container without theme styles; the text style is inherited by the cells
+    clock->cont = lv_obj_create(parent);
+    lv_obj_remove_style_all(clock->cont);
+    lv_obj_clear_flag(clock->cont, LV_OBJ_FLAG_SCROLLABLE | LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_style_text_color(clock->cont, color, 0);
+    lv_obj_set_style_text_font(clock->cont, font, 0);
+
+#if APP_GLYPH_CACHE
+    // Fall back to labels if the cells can't be allocated
+    lv_color_t bg_color = lv_obj_get_style_bg_color(parent, LV_PART_MAIN);
+    if (!glyph_cache_init(&clock->digits, font, CLOCK_WIDGET_DIGITS, digit_w, color, bg_color) ||
+        !glyph_cache_init(&clock->colon, font, ":", colon_w, color, bg_color)) {
+        glyph_cache_deinit(&clock->digits);
+    }
+#endif
+
+    lv_coord_t x = 0;
+    for(int i = 0; i < CLOCK_WIDGET_CELL_CNT; i++) {
+        // Every third character is a separator: "HH:MM:SS"
+        lv_coord_t cell_w = (i % 3 == 2) ? colon_w : digit_w;
+
+        clock->text[i] = (i % 3 == 2) ? ':' : '0';
+        create_cell(clock, i, clock->text[i]);
+        lv_obj_set_width(clock->cells[i], cell_w);
+        lv_obj_set_pos(clock->cells[i], x, 0);
+        x += cell_w;
+    }
+    clock->text[CLOCK_WIDGET_CELL_CNT] = '\0';
+
+    lv_obj_set_size(clock->cont, x, h);
+
+    return clock->cont;
+}
+
+void clock_widget_get_size(const lv_font_t *font, lv_point_t *size)
+{
+    lv_coord_t digit_w = get_max_glyph_width(font, CLOCK_WIDGET_DIGITS);
+    lv_coord_t colon_w = get_max_glyph_width(font, ":");
+
+    // Six digits and two separators
+    size->x = (lv_coord_t)(digit_w * 6 + colon_w * 2);
+    size->y = lv_font_get_line_height(font);
+}
+
+void clock_widget_set_text(clock_widget_t *clock, const char *text)
+{
+    for(int i = 0; i < CLOCK_WIDGET_CELL_CNT && text[i] != '\0'; i++) {
+        if (text[i] == clock->text[i]) continue;
+
+        // Changing the cell invalidates only this cell
+        set_cell_char(clock, i, text[i]);
+        clock->text[i] = text[i];
+    }
+}
+
+void clock_widget_show_seconds(clock_widget_t *clock, bool en)
+{
+    // Hiding invalidates only the hidden cells
+    for(int i = CLOCK_WIDGET_HM_CNT; i < CLOCK_WIDGET_CELL_CNT; i++) {
+        if (en) {
+            lv_obj_clear_flag(clock->cells[i], LV_OBJ_FLAG_HIDDEN);
+        } else {
+            lv_obj_add_flag(clock->cells[i], LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+}
+
+/**
+ * Get the widest advance width among the given characters
+ */
+static lv_coord_t get_max_glyph_width(const lv_font_t *font, const char *chars)
+{
+    lv_coord_t max_w = 0;
+
+    for(; *chars != '\0'; chars++) {
+        lv_coord_t w = lv_font_get_glyph_width(font, (uint32_t)*chars, 0);
+        if (w > max_w) max_w = w;
+    }
+
+    return max_w;
+}
+
+/**
+ * Create a cell showing a character: an image of the cached glyph, or a label
+ */
+static void create_cell(clock_widget_t *clock, int i, char c)
+{
+#if APP_GLYPH_CACHE
+    if (clock->digits.cnt > 0) {
+        clock->cells[i] = lv_img_create(clock->cont);
+        set_cell_char(clock, i, c);
+        return;
+    }
+#endif
+
+    clock->cells[i] = lv_label_create(clock->cont);
+    lv_obj_set_style_text_align(clock->cells[i], LV_TEXT_ALIGN_CENTER, 0);
+    set_cell_char(clock, i, c);
+}
+
+static void set_cell_char(clock_widget_t *clock, int i, char c)
+{
+#if APP_GLYPH_CACHE
+    if (clock->digits.cnt > 0) {
+        const lv_img_dsc_t *img = glyph_cache_get(c == ':' ? &clock->colon : &clock->digits, c);
+        // Not a digit: keep the previous glyph rather than showing nothing
+        if (img) lv_img_set_src(clock->cells[i], img);
+        return;
+    }
+#endif
+
+    // The label shows the cell's own buffer, so changing it allocates nothing
+    clock->cell_texts[i][0] = c;
+    clock->cell_texts[i][1] = '\0';
+    lv_label_set_text_static(clock->cells[i], clock->cell_texts[i]);
+}
@@ -0,0 +1,70 @@
+/**
+ * @file clock_widget.h
+ * "HH:MM:SS" clock made of fixed width cells, one label per character.
+ * Only the cells whose character changed get invalidated on an update.
+ * With `APP_GLYPH_CACHE` the cells are images of pre-rendered glyphs
+ * (see glyph_cache.h) instead of labels.
+ */
+
+#ifndef CLOCK_WIDGET_H
+#define CLOCK_WIDGET_H
+
+#include "lvgl/lvgl.h"
+#include "app_conf.h"
+#include "glyph_cache.h"
+
+/*Number of characters in "HH:MM:SS"*/
+#define CLOCK_WIDGET_CELL_CNT 8
+
+/*Number of characters in "HH:MM"*/
+#define CLOCK_WIDGET_HM_CNT 5
+
+/*Characters the cells can show*/
+#define CLOCK_WIDGET_DIGITS "0123456789"
+#define CLOCK_WIDGET_CHARS  CLOCK_WIDGET_DIGITS ":"
+
+typedef struct {
+    lv_obj_t *cont;
+    lv_obj_t *cells[CLOCK_WIDGET_CELL_CNT];
+    char text[CLOCK_WIDGET_CELL_CNT + 1];   /*Characters currently shown by the cells*/
+    char cell_texts[CLOCK_WIDGET_CELL_CNT][2];  /*Static texts of the label cells*/
+#if APP_GLYPH_CACHE
+    glyph_cache_t digits;
+    glyph_cache_t colon;
+#endif
+} clock_widget_t;
+
+/**
+ * Create a clock widget
+ * @param clock     widget descriptor to initialize (must stay valid while the widget exists)
+ * @param parent    parent object
+ * @param font      font of the digits
+ * @param color     color of the digits
+ * @return          the container object (to align and style it)
+ * @note            with `APP_GLYPH_CACHE` the glyphs are blended onto the background
+ *                  color of `parent`, which must not change afterwards
+ */
+lv_obj_t *clock_widget_create(clock_widget_t *clock, lv_obj_t *parent, const lv_font_t *font, lv_color_t color);
+
+/**
+ * Get the size of the widget with a font without creating it (see ui_layout.h)
+ * @param font      font of the digits
+ * @param size      store the width and the height here
+ */
+void clock_widget_get_size(const lv_font_t *font, lv_point_t *size);
+
+/**
+ * Show a new time. Only the cells with a different character are updated.
+ * @param clock     widget descriptor
+ * @param text      "HH:MM:SS" formatted time (characters past the last cell are ignored)
+ */
+void clock_widget_set_text(clock_widget_t *clock, const char *text);
+
+/**
+ * Show or hide the ":SS" cells. The other cells keep their position.
+ * @param clock     widget descriptor
+ * @param en        true to show the seconds
+ */
+void clock_widget_show_seconds(clock_widget_t *clock, bool en);
+
+#endif /*CLOCK_WIDGET_H*/
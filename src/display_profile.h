@@ -0,0 +1,131 @@
+/**
+ * @file display_profile.h
+ * Compile-time profiles of the supported panels
+ *
+ * A profile sets the resolution, the default draw buffer strategy, the fonts
+ * and the layout offsets of one panel. It is selected with `APP_DISPLAY_PROFILE`
+ * (the CMake option of the same name, or one target per profile, see
+ * CMakeLists.txt). Every value is `#ifndef` guarded like the rest of app_conf.h.
+ * The fonts have to be enabled in lv_conf.h.
+ */
+
+#ifndef DISPLAY_PROFILE_H
+#define DISPLAY_PROFILE_H
+
+#define DISPLAY_PROFILE_172X320 0   /*1.47" bar*/
+#define DISPLAY_PROFILE_240X280 1   /*1.69" rounded rectangle*/
+#define DISPLAY_PROFILE_466X466 2   /*1.43" round AMOLED*/
+
+#ifndef APP_DISPLAY_PROFILE
+    #define APP_DISPLAY_PROFILE DISPLAY_PROFILE_172X320
+#endif
+
+#if APP_DISPLAY_PROFILE == DISPLAY_PROFILE_172X320
+    #define APP_DISPLAY_NAME "1.47\" 172x320"
+    #ifndef SCREEN_WIDTH
+        #define SCREEN_WIDTH  172
+    #endif
+    #ifndef SCREEN_HEIGHT
+        #define SCREEN_HEIGHT 320
+    #endif
+    /*Two 10 line buffers (6.9 kB)*/
+    #ifndef APP_DRAW_BUF_MODE
+        #define APP_DRAW_BUF_MODE DRAW_BUF_PARTIAL
+    #endif
+    #ifndef APP_DRAW_BUF_LINES
+        #define APP_DRAW_BUF_LINES 10
+    #endif
+    #ifndef APP_FONT_WELCOME
+        #define APP_FONT_WELCOME lv_font_montserrat_24
+    #endif
+    #ifndef APP_FONT_CLOCK
+        #define APP_FONT_CLOCK lv_font_montserrat_28
+    #endif
+    #ifndef APP_FONT_DATE
+        #define APP_FONT_DATE lv_font_montserrat_14
+    #endif
+    /*Offsets of the clock's and the date's center from the screen's center*/
+    #ifndef APP_LAYOUT_CLOCK_Y
+        #define APP_LAYOUT_CLOCK_Y -20
+    #endif
+    #ifndef APP_LAYOUT_DATE_Y
+        #define APP_LAYOUT_DATE_Y 30
+    #endif
+    #ifndef APP_SDL_ZOOM
+        #define APP_SDL_ZOOM 2
+    #endif
+
+#elif APP_DISPLAY_PROFILE == DISPLAY_PROFILE_240X280
+    #define APP_DISPLAY_NAME "1.69\" 240x280"
+    #ifndef SCREEN_WIDTH
+        #define SCREEN_WIDTH  240
+    #endif
+    #ifndef SCREEN_HEIGHT
+        #define SCREEN_HEIGHT 280
+    #endif
+    /*Two 28 line buffers (26.9 kB): a tenth of the screen, as on the small panel*/
+    #ifndef APP_DRAW_BUF_MODE
+        #define APP_DRAW_BUF_MODE DRAW_BUF_PARTIAL
+    #endif
+    #ifndef APP_DRAW_BUF_LINES
+        #define APP_DRAW_BUF_LINES 28
+    #endif
+    #ifndef APP_FONT_WELCOME
+        #define APP_FONT_WELCOME lv_font_montserrat_28
+    #endif
+    #ifndef APP_FONT_CLOCK
+        #define APP_FONT_CLOCK lv_font_montserrat_36
+    #endif
+    #ifndef APP_FONT_DATE
+        #define APP_FONT_DATE lv_font_montserrat_16
+    #endif
+    #ifndef APP_LAYOUT_CLOCK_Y
+        #define APP_LAYOUT_CLOCK_Y -24
+    #endif
+    #ifndef APP_LAYOUT_DATE_Y
+        #define APP_LAYOUT_DATE_Y 36
+    #endif
+    #ifndef APP_SDL_ZOOM
+        #define APP_SDL_ZOOM 2
+    #endif
+
+#elif APP_DISPLAY_PROFILE == DISPLAY_PROFILE_466X466
+    #define APP_DISPLAY_NAME "1.43\" 466x466"
+    #ifndef SCREEN_WIDTH
+        #define SCREEN_WIDTH  466
+    #endif
+    #ifndef SCREEN_HEIGHT
+        #define SCREEN_HEIGHT 466
+    #endif
+    /*The AMOLED controllers keep a frame in their GRAM: LVGL renders only the changed
+     *areas into the panel framebuffer instead of 2 x 46 lines (86 kB) of bands*/
+    #ifndef APP_DRAW_BUF_MODE
+        #define APP_DRAW_BUF_MODE DRAW_BUF_DIRECT_FB
+    #endif
+    #ifndef APP_DRAW_BUF_LINES
+        #define APP_DRAW_BUF_LINES 46
+    #endif
+    #ifndef APP_FONT_WELCOME
+        #define APP_FONT_WELCOME lv_font_montserrat_36
+    #endif
+    #ifndef APP_FONT_CLOCK
+        #define APP_FONT_CLOCK lv_font_montserrat_48
+    #endif
+    #ifndef APP_FONT_DATE
+        #define APP_FONT_DATE lv_font_montserrat_24
+    #endif
+    #ifndef APP_LAYOUT_CLOCK_Y
+        #define APP_LAYOUT_CLOCK_Y -36
+    #endif
+    #ifndef APP_LAYOUT_DATE_Y
+        #define APP_LAYOUT_DATE_Y 48
+    #endif
+    #ifndef APP_SDL_ZOOM
+        #define APP_SDL_ZOOM 1
+    #endif
+
+#else
+    #error "Unknown APP_DISPLAY_PROFILE"
+#endif
+
+#endif /*DISPLAY_PROFILE_H*/
@@ -0,0 +1,138 @@
+/**
+ * @file draw_backend.c
+ * Selectable draw unit of LVGL (software renderer or a 2D accelerator)
+ */
+
+#include "draw_backend.h"
+#include "app_conf.h"
+#include "par_render.h"
+#include <stdio.h>
+#include <string.h>
+
+#if LV_USE_GPU_STM32_DMA2D
+#include "lvgl/src/draw/stm32_dma2d/lv_gpu_stm32_dma2d.h"
+#endif
+#if LV_USE_GPU_ARM2D
+#include "lvgl/src/draw/arm2d/lv_gpu_arm2d.h"
+#endif
+#if LV_USE_GPU_NXP_PXP
+#include "lvgl/src/draw/nxp/lv_gpu_nxp.h"
+#endif
+
+typedef void (*draw_ctx_cb_t)(lv_disp_drv_t *, lv_draw_ctx_t *);
+
+typedef struct {
+    const char *name;
+    draw_ctx_cb_t init;
+    draw_ctx_cb_t deinit;
+    size_t size;
+    const char *missing;        /*Why it can't be used (`init` is NULL)*/
+} backend_dsc_t;
+
+static const backend_dsc_t backends[_DRAW_BACKEND_CNT] = {
+    [DRAW_BACKEND_AUTO] = { "auto", NULL, NULL, 0, "not a backend" },
+    [DRAW_BACKEND_SW] = { "sw", lv_draw_sw_init_ctx, lv_draw_sw_deinit_ctx, sizeof(lv_draw_sw_ctx_t), NULL },
+#if APP_PAR_RENDER
+    [DRAW_BACKEND_SW_BANDS] = { "sw-bands", par_render_draw_ctx_init, lv_draw_sw_deinit_ctx, sizeof(lv_draw_sw_ctx_t), NULL },
+#else
+    [DRAW_BACKEND_SW_BANDS] = { "sw-bands", NULL, NULL, 0, "APP_PAR_RENDER is disabled" },
+#endif
+#if LV_USE_GPU_STM32_DMA2D
+    [DRAW_BACKEND_DMA2D] = { "dma2d", lv_draw_stm32_dma2d_ctx_init, lv_draw_stm32_dma2d_ctx_deinit, sizeof(lv_draw_stm32_dma2d_ctx_t), NULL },
+#else
+    [DRAW_BACKEND_DMA2D] = { "dma2d", NULL, NULL, 0, "not built (APP_DRAW_BACKEND=dma2d)" },
+#endif
+#if LV_USE_GPU_ARM2D
+    [DRAW_BACKEND_ARM2D] = { "arm2d", lv_draw_arm2d_ctx_init, lv_draw_arm2d_ctx_deinit, sizeof(lv_draw_arm2d_ctx_t), NULL },
+#else
+    [DRAW_BACKEND_ARM2D] = { "arm2d", NULL, NULL, 0, "not built (APP_DRAW_BACKEND=arm2d)" },
+#endif
+#if LV_USE_GPU_NXP_PXP
+    [DRAW_BACKEND_PXP] = { "pxp", lv_draw_nxp_ctx_init, lv_draw_nxp_ctx_deinit, sizeof(lv_draw_nxp_ctx_t), NULL },
+#else
+    [DRAW_BACKEND_PXP] = { "pxp", NULL, NULL, 0, "not built (APP_DRAW_BACKEND=pxp)" },
+#endif
+};
+
+// Order of preference of DRAW_BACKEND_AUTO
+static const draw_backend_t auto_order[] = {
+    DRAW_BACKEND_DMA2D, DRAW_BACKEND_PXP, DRAW_BACKEND_ARM2D, DRAW_BACKEND_SW_BANDS, DRAW_BACKEND_SW
+};
+
+static draw_backend_t pick_auto(void);
+
+bool draw_backend_parse(const char *str, draw_backend_t *backend)
+{
+    for(int b = 0; b < _DRAW_BACKEND_CNT; b++) {
+        if (strcmp(str, backends[b].name) == 0) {
+            *backend = (draw_backend_t)b;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+const char *draw_backend_get_missing(draw_backend_t backend)
+{
+    if ((unsigned)backend >= _DRAW_BACKEND_CNT) return "unknown backend";
+
+    return backends[backend].init ? NULL : backends[backend].missing;
+}
+
+draw_backend_t draw_backend_setup(lv_disp_drv_t *drv, draw_backend_t backend)
+{
+    const char *missing = draw_backend_get_missing(backend);
+    if (backend != DRAW_BACKEND_AUTO && missing) {
+        draw_backend_t fallback = pick_auto();
+        printf("Draw backend %s: %s, falling back to %s\n", draw_backend_name(backend), missing,
+               draw_backend_name(fallback));
+        backend = fallback;
+    } else if (backend == DRAW_BACKEND_AUTO) {
+        backend = pick_auto();
+    }
+
+    drv->draw_ctx_init = backends[backend].init;
+    drv->draw_ctx_deinit = backends[backend].deinit;
+    drv->draw_ctx_size = backends[backend].size;
+
+    return backend;
+}
+
+bool draw_backend_switch(lv_disp_t *disp, draw_backend_t backend)
+{
+    if (draw_backend_get_missing(backend)) return false;
+
+    lv_disp_drv_t *drv = disp->driver;
+    lv_draw_ctx_t *draw_ctx = lv_mem_alloc(backends[backend].size);
+    if (!draw_ctx) return false;
+
+    if (drv->draw_ctx) {
+        drv->draw_ctx_deinit(drv, drv->draw_ctx);
+        lv_mem_free(drv->draw_ctx);
+    }
+
+    drv->draw_ctx_init = backends[backend].init;
+    drv->draw_ctx_deinit = backends[backend].deinit;
+    drv->draw_ctx_size = backends[backend].size;
+    drv->draw_ctx_init(drv, draw_ctx);
+    drv->draw_ctx = draw_ctx;
+
+    return true;
+}
+
+const char *draw_backend_name(draw_backend_t backend)
+{
+    if ((unsigned)backend >= _DRAW_BACKEND_CNT) return "unknown";
+
+    return backends[backend].name;
+}
+
+static draw_backend_t pick_auto(void)
+{
+    for(size_t i = 0; i < sizeof(auto_order) / sizeof(auto_order[0]); i++) {
+        if (!draw_backend_get_missing(auto_order[i])) return auto_order[i];
+    }
+
+    return DRAW_BACKEND_SW;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file draw_backend.h
+ * Selectable draw unit of LVGL (software renderer or a 2D accelerator)
+ *
+ * The accelerators are compiled into LVGL by the APP_DRAW_BACKEND CMake
+ * option (see lv_conf.h). At runtime the requested backend is used if it
+ * was built, and the software renderer otherwise.
+ * LVGL's SDL draw unit is not offered: it renders into SDL textures with
+ * 32 bit colors, while the display pipeline here is RGB565 in CPU memory.
+ */
+
+#ifndef DRAW_BACKEND_H
+#define DRAW_BACKEND_H
+
+#include "lvgl/lvgl.h"
+#include <stdbool.h>
+
+typedef enum {
+    DRAW_BACKEND_AUTO,      /*The first available of dma2d, pxp, arm2d, sw-bands, sw*/
+    DRAW_BACKEND_SW,        /*LVGL's software renderer*/
+    DRAW_BACKEND_SW_BANDS,  /*Software renderer with the large blends in bands on the par_render.h pool*/
+    DRAW_BACKEND_DMA2D,     /*STM32 Chrom-ART (DMA2D)*/
+    DRAW_BACKEND_ARM2D,     /*Arm-2D (Helium/DSP accelerated Cortex-M)*/
+    DRAW_BACKEND_PXP,       /*NXP i.MX RT PXP*/
+    _DRAW_BACKEND_CNT
+} draw_backend_t;
+
+/**
+ * Parse a backend given as "auto", "sw", "sw-bands", "dma2d", "arm2d" or "pxp"
+ * @param str       the string to parse
+ * @param backend   the parsed backend
+ * @return          false if the string is not a valid backend
+ */
+bool draw_backend_parse(const char *str, draw_backend_t *backend);
+
+/**
+ * Check if a backend can be used in this build
+ * @param backend   the backend
+ * @return          NULL if available, otherwise the reason why not
+ */
+const char *draw_backend_get_missing(draw_backend_t backend);
+
+/**
+ * Configure the draw context of a display driver for a backend, or for the
+ * software renderer if it's not available
+ * @param drv       display driver (before `lv_disp_drv_register()`)
+ * @param backend   the requested backend
+ * @return          the backend which will be used
+ */
+draw_backend_t draw_backend_setup(lv_disp_drv_t *drv, draw_backend_t backend);
+
+/**
+ * Replace the draw context of a registered display (e.g. to compare the backends)
+ * @param disp      the display
+ * @param backend   the new backend
+ * @return          false if the backend is not available or the context couldn't be allocated
+ */
+bool draw_backend_switch(lv_disp_t *disp, draw_backend_t backend);
+
+/**
+ * Get the name of a backend (as accepted by `draw_backend_parse()`)
+ */
+const char *draw_backend_name(draw_backend_t backend);
+
+#endif /*DRAW_BACKEND_H*/
@@ -0,0 +1,132 @@
+/**
+ * @file draw_buf.c
+ * Selectable draw buffer strategies of the display driver
+ */
+
+#include "draw_buf.h"
+#include "app_conf.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static lv_disp_draw_buf_t disp_buf;
+static lv_color_t *panel_fb;
+
+bool draw_buf_parse(const char *str, draw_buf_mode_t *mode, uint32_t *lines)
+{
+    if (strncmp(str, "partial", 7) == 0) {
+        if (str[7] == ':') {
+            long n = strtol(str + 8, NULL, 10);
+            if (n <= 0) return false;
+            *lines = (uint32_t)n;
+        } else if (str[7] != '\0') {
+            return false;
+        }
+        *mode = DRAW_BUF_PARTIAL;
+    } else if (strcmp(str, "full") == 0) {
+        *mode = DRAW_BUF_FULL;
+    } else if (strcmp(str, "full-refresh") == 0) {
+        *mode = DRAW_BUF_FULL_REFRESH;
+    } else if (strcmp(str, "direct") == 0) {
+        *mode = DRAW_BUF_DIRECT;
+    } else if (strcmp(str, "direct-fb") == 0) {
+        *mode = DRAW_BUF_DIRECT_FB;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+void draw_buf_set_panel_fb(lv_color_t *fb)
+{
+    panel_fb = fb;
+}
+
+bool draw_buf_setup(lv_disp_drv_t *drv, draw_buf_mode_t mode, uint32_t lines)
+{
+    uint32_t frame_px = (uint32_t)drv->hor_res * drv->ver_res;
+    uint32_t buf_px = frame_px;
+    bool double_buf = true;
+
+    switch (mode) {
+    case DRAW_BUF_PARTIAL:
+        if (lines > (uint32_t)drv->ver_res) lines = drv->ver_res;
+        buf_px = (uint32_t)drv->hor_res * lines;
+        break;
+    case DRAW_BUF_FULL:
+        double_buf = false;
+        break;
+    case DRAW_BUF_FULL_REFRESH:
+        drv->full_refresh = 1;
+        break;
+    case DRAW_BUF_DIRECT:
+        drv->direct_mode = 1;
+        break;
+    case DRAW_BUF_DIRECT_FB:
+        // Single buffer: the panel memory is always up to date, nothing to sync
+        if (!panel_fb) {
+            printf("The display backend has no framebuffer for direct-fb\n");
+            return false;
+        }
+        drv->direct_mode = 1;
+        lv_disp_draw_buf_init(&disp_buf, panel_fb, NULL, frame_px);
+        drv->draw_buf = &disp_buf;
+        return true;
+    }
+
+    lv_color_t *buf1 = malloc(buf_px * sizeof(lv_color_t));
+    lv_color_t *buf2 = double_buf ? malloc(buf_px * sizeof(lv_color_t)) : NULL;
+    if (!buf1 || (double_buf && !buf2)) {
+        printf("Can't allocate the draw buffers (%u bytes)\n",
+               (unsigned)(buf_px * sizeof(lv_color_t) * (double_buf ? 2 : 1)));
+        free(buf1);
+        free(buf2);
+        return false;
+    }
+
+    lv_disp_draw_buf_init(&disp_buf, buf1, buf2, buf_px);
+    drv->draw_buf = &disp_buf;
+
+    return true;
+}
+
+uint32_t draw_buf_get_flush_areas(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p,
+                                  lv_area_t *areas, const lv_color_t **srcs, int32_t *stride)
+{
+    if (!drv->direct_mode) {
+        *stride = lv_area_get_width(area);
+        areas[0] = *area;
+        srcs[0] = color_p;
+        return 1;
+    }
+
+    // The buffer has the size of the screen and `area` is always the full screen.
+    // The redrawn areas are known once the last one is rendered.
+    uint32_t cnt = 0;
+    *stride = drv->hor_res;
+    if (lv_disp_flush_is_last(drv)) {
+        lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+        for(uint32_t i = 0; i < disp->inv_p; i++) {
+            if (disp->inv_area_joined[i]) continue;
+            areas[cnt] = disp->inv_areas[i];
+            srcs[cnt] = color_p + areas[cnt].y1 * drv->hor_res + areas[cnt].x1;
+            cnt++;
+        }
+    }
+
+    return cnt;
+}
+
+const char *draw_buf_mode_name(draw_buf_mode_t mode)
+{
+    switch (mode) {
+    case DRAW_BUF_PARTIAL:      return "partial";
+    case DRAW_BUF_FULL:         return "full";
+    case DRAW_BUF_FULL_REFRESH: return "full-refresh";
+    case DRAW_BUF_DIRECT:       return "direct";
+    case DRAW_BUF_DIRECT_FB:    return "direct-fb";
+    }
+
+    return "unknown";
+}
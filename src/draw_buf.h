@@ -0,0 +1,67 @@
+/**
+ * @file draw_buf.h
+ * Selectable draw buffer strategies of the display driver
+ */
+
+#ifndef DRAW_BUF_H
+#define DRAW_BUF_H
+
+#include "lvgl/lvgl.h"
+#include <stdbool.h>
+
+typedef enum {
+    DRAW_BUF_PARTIAL,       /*Two N-line buffers, only the invalidated areas are rendered*/
+    DRAW_BUF_FULL,          /*One full-frame buffer, only the invalidated areas are rendered*/
+    DRAW_BUF_FULL_REFRESH,  /*Two full-frame buffers, the whole screen is redrawn on every change*/
+    DRAW_BUF_DIRECT,        /*Two full-frame buffers rendered on absolute coordinates (`direct_mode`)*/
+    DRAW_BUF_DIRECT_FB,     /*`direct_mode` into the panel's own framebuffer (see `draw_buf_set_panel_fb()`)*/
+} draw_buf_mode_t;
+
+/**
+ * Parse a mode given as "partial[:lines]", "full", "full-refresh", "direct" or "direct-fb"
+ * @param str       the string to parse
+ * @param mode      the parsed mode
+ * @param lines     the parsed number of lines (only changed for "partial:lines")
+ * @return          false if the string is not a valid mode
+ */
+bool draw_buf_parse(const char *str, draw_buf_mode_t *mode, uint32_t *lines);
+
+/**
+ * Set the framebuffer of the display backend which LVGL renders into with
+ * `DRAW_BUF_DIRECT_FB`: nothing is copied on flush, the backend only has to
+ * send or upload the redrawn areas. Call it before `draw_buf_setup()`.
+ * @param fb        `hor_res * ver_res` pixels (e.g. the mmap'd panel memory)
+ */
+void draw_buf_set_panel_fb(lv_color_t *fb);
+
+/**
+ * Allocate the buffers of the given mode and configure the driver for it.
+ * `hor_res`, `ver_res` and `flush_cb` of the driver must be set already.
+ * @param drv       display driver to configure (before `lv_disp_drv_register()`)
+ * @param mode      draw buffer strategy
+ * @param lines     number of lines per buffer with `DRAW_BUF_PARTIAL`
+ * @return          false if the buffers couldn't be allocated
+ */
+bool draw_buf_setup(lv_disp_drv_t *drv, draw_buf_mode_t mode, uint32_t lines);
+
+/**
+ * Get the areas a flush callback has to send to the panel. In `direct_mode` these
+ * are the areas redrawn in the current refresh (only on the last flush), otherwise
+ * the flushed area itself.
+ * @param drv       display driver passed to the flush callback
+ * @param area      area passed to the flush callback
+ * @param color_p   buffer passed to the flush callback
+ * @param areas     array of `LV_INV_BUF_SIZE` elements to store the areas
+ * @param srcs      array of `LV_INV_BUF_SIZE` elements to store the first pixel of each area
+ * @param stride    width of the source buffer in pixels
+ * @return          number of areas
+ */
+uint32_t draw_buf_get_flush_areas(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p,
+                                  lv_area_t *areas, const lv_color_t **srcs, int32_t *stride);
+
+/**
+ * Get the name of a mode (as accepted by `draw_buf_parse()`)
+ */
+const char *draw_buf_mode_name(draw_buf_mode_t mode);
+
+#endif /*DRAW_BUF_H*/
@@ -0,0 +1,166 @@
+/**
+ * @file flush_sched.c
+ * Flush scheduler between LVGL and the panel driver
+ */
+
+#include "flush_sched.h"
+
+#if APP_FLUSH_SCHED
+
+#include "app_tick.h"
+
+#if APP_FLUSH_SCHED_ALIGN < 1 || (APP_FLUSH_SCHED_ALIGN & (APP_FLUSH_SCHED_ALIGN - 1)) != 0
+#error "APP_FLUSH_SCHED_ALIGN must be a power of 2"
+#endif
+
+typedef void (*rounder_cb_t)(lv_disp_drv_t *, lv_area_t *);
+
+static lv_disp_t *sched_disp;
+static rounder_cb_t user_rounder_cb;
+static lv_timer_cb_t user_refr_cb;
+
+static lv_coord_t default_scan_line(void);
+static flush_sched_scan_line_cb_t scan_line_cb = default_scan_line;
+
+static void rounder_cb(lv_disp_drv_t *drv, lv_area_t *area);
+static void refr_timer_cb(lv_timer_t *timer);
+static uint32_t merge_areas(lv_area_t *areas, uint32_t cnt);
+static void sort_areas(lv_area_t *areas, uint32_t cnt, lv_coord_t scan_line, lv_coord_t ver_res);
+
+void flush_sched_attach(lv_disp_t *disp)
+{
+    sched_disp = disp;
+
+    user_rounder_cb = disp->driver->rounder_cb;
+    disp->driver->rounder_cb = rounder_cb;
+
+    user_refr_cb = disp->refr_timer->timer_cb;
+    lv_timer_set_cb(disp->refr_timer, refr_timer_cb);
+}
+
+void flush_sched_set_scan_line_cb(flush_sched_scan_line_cb_t cb)
+{
+    scan_line_cb = cb ? cb : default_scan_line;
+}
+
+/**
+ * Align the column window of the area, e.g. to even start and width
+ */
+static void rounder_cb(lv_disp_drv_t *drv, lv_area_t *area)
+{
+    if (user_rounder_cb) user_rounder_cb(drv, area);
+
+    area->x1 &= ~(lv_coord_t)(APP_FLUSH_SCHED_ALIGN - 1);
+    area->x2 |= (lv_coord_t)(APP_FLUSH_SCHED_ALIGN - 1);
+    if (area->x2 >= drv->hor_res) area->x2 = drv->hor_res - 1;
+}
+
+/**
+ * Rewrite the invalidated areas of the display before LVGL refreshes them
+ */
+static void refr_timer_cb(lv_timer_t *timer)
+{
+    lv_disp_t *disp = sched_disp;
+    lv_area_t areas[LV_INV_BUF_SIZE];
+    uint32_t cnt = 0;
+
+    // With full_refresh or a full screen invalidation there is nothing to schedule
+    if (disp->inv_p > 1 && !disp->driver->full_refresh) {
+        for(uint32_t i = 0; i < disp->inv_p; i++) {
+            if (!disp->inv_area_joined[i]) areas[cnt++] = disp->inv_areas[i];
+        }
+
+        cnt = merge_areas(areas, cnt);
+        sort_areas(areas, cnt, scan_line_cb(), disp->driver->ver_res);
+
+        for(uint32_t i = 0; i < cnt; i++) {
+            disp->inv_areas[i] = areas[i];
+            disp->inv_area_joined[i] = 0;
+        }
+        disp->inv_p = (uint16_t)cnt;
+    }
+
+    user_refr_cb(timer);
+}
+
+/**
+ * Merge two areas if one window around both costs less than two windows
+ */
+static bool try_merge(lv_area_t *a, const lv_area_t *b)
+{
+    lv_area_t joined;
+    _lv_area_join(&joined, a, b);
+
+    // The overlap would be counted twice in `size(a) + size(b)`, so it's a merge candidate too
+    uint32_t cost_sep = lv_area_get_size(a) + lv_area_get_size(b) + APP_FLUSH_SCHED_WINDOW_COST;
+    if (lv_area_get_size(&joined) > cost_sep) return false;
+
+    *a = joined;
+    return true;
+}
+
+/**
+ * Merge the areas until no pair is worth merging
+ * @return      the new number of areas
+ */
+static uint32_t merge_areas(lv_area_t *areas, uint32_t cnt)
+{
+    bool merged;
+
+    do {
+        merged = false;
+        for(uint32_t i = 0; i < cnt; i++) {
+            for(uint32_t j = i + 1; j < cnt; j++) {
+                if (!try_merge(&areas[i], &areas[j])) continue;
+
+                areas[j] = areas[cnt - 1];
+                cnt--;
+                j = i;  // the grown area can absorb earlier ones too
+                merged = true;
+            }
+        }
+    } while (merged);
+
+    return cnt;
+}
+
+/**
+ * Order the areas by how long ago the scan line left them: the area just
+ * behind the scan line has a whole frame period before it's read out again,
+ * while the one just ahead of it is sent last, after the scan line passed it
+ */
+static void sort_areas(lv_area_t *areas, uint32_t cnt, lv_coord_t scan_line, lv_coord_t ver_res)
+{
+    lv_coord_t keys[LV_INV_BUF_SIZE];
+
+    for(uint32_t i = 0; i < cnt; i++) {
+        keys[i] = (lv_coord_t)((scan_line - 1 - areas[i].y2 + ver_res) % ver_res);
+    }
+
+    // Insertion sort, there are at most LV_INV_BUF_SIZE areas
+    for(uint32_t i = 1; i < cnt; i++) {
+        lv_area_t area = areas[i];
+        lv_coord_t key = keys[i];
+        uint32_t j = i;
+        for(; j > 0 && keys[j - 1] > key; j--) {
+            areas[j] = areas[j - 1];
+            keys[j] = keys[j - 1];
+        }
+        areas[j] = area;
+        keys[j] = key;
+    }
+}
+
+/**
+ * Scan line of a panel refreshing at `APP_FLUSH_SCHED_PANEL_HZ` since the start
+ */
+static lv_coord_t default_scan_line(void)
+{
+    uint64_t period_us = 1000000 / APP_FLUSH_SCHED_PANEL_HZ;
+    uint64_t phase_us = app_tick_get_us() % period_us;
+    lv_coord_t ver_res = sched_disp->driver->ver_res;
+
+    return (lv_coord_t)(phase_us * ver_res / period_us);
+}
+
+#endif /*APP_FLUSH_SCHED*/
@@ -0,0 +1,40 @@
+/**
+ * @file flush_sched.h
+ * Flush scheduler between LVGL and the panel driver
+ *
+ * Before every refresh the invalidated areas of the display are
+ * - aligned to the column granularity of the panel controller (rounder),
+ * - merged when they overlap, touch, or are so close that one bigger window
+ *   is cheaper than a second window setup,
+ * - ordered to chase the tearing effect (TE) line: the area the scan line has
+ *   just left is rendered and sent first, the one it is about to reach last.
+ */
+
+#ifndef FLUSH_SCHED_H
+#define FLUSH_SCHED_H
+
+#include "lvgl/lvgl.h"
+#include "app_conf.h"
+
+/*Return the line the panel is scanning out now (0 .. ver_res - 1)*/
+typedef lv_coord_t (*flush_sched_scan_line_cb_t)(void);
+
+#if APP_FLUSH_SCHED
+
+/**
+ * Schedule the flushes of a display: wraps its rounder and refresh timer
+ * callbacks. Call it after `lv_disp_drv_register()`.
+ * @param disp      the display
+ */
+void flush_sched_attach(lv_disp_t *disp);
+
+/**
+ * Set where the scan line position comes from, e.g. the time since the last
+ * TE interrupt. By default it's simulated from the tick and `APP_FLUSH_SCHED_PANEL_HZ`.
+ * @param cb        the new source, NULL to restore the default
+ */
+void flush_sched_set_scan_line_cb(flush_sched_scan_line_cb_t cb);
+
+#endif /*APP_FLUSH_SCHED*/
+
+#endif /*FLUSH_SCHED_H*/
@@ -0,0 +1,131 @@
+/**
+ * @file flush_worker.c
+ * Transfer thread simulating the SPI/DMA path of the panel
+ */
+
+#include "flush_worker.h"
+#include "app_conf.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+
+/*LVGL waits for the flush ready signal before flushing again, so one job slot is enough*/
+typedef struct {
+    lv_disp_drv_t *drv;
+    lv_area_t areas[LV_INV_BUF_SIZE];
+    const lv_color_t *srcs[LV_INV_BUF_SIZE];
+    uint32_t cnt;
+    int32_t src_stride;
+    bool last;
+} flush_job_t;
+
+static pthread_t thread;
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+static flush_job_t job;
+static bool job_pending;
+static bool running;
+
+static flush_worker_transfer_cb_t transfer_cb;
+static flush_worker_done_cb_t done_cb;
+
+static void *worker_thread(void *arg);
+static void simulate_bus_time(uint32_t px);
+
+bool flush_worker_init(flush_worker_transfer_cb_t transfer, flush_worker_done_cb_t done)
+{
+    transfer_cb = transfer;
+    done_cb = done;
+    running = true;
+    job_pending = false;
+
+    if (pthread_create(&thread, NULL, worker_thread, NULL) != 0) {
+        printf("Can't create the flush thread\n");
+        running = false;
+        return false;
+    }
+
+    return true;
+}
+
+void flush_worker_deinit(void)
+{
+    if (!running) return;
+
+    pthread_mutex_lock(&mutex);
+    running = false;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+
+    pthread_join(thread, NULL);
+}
+
+void flush_worker_submit(lv_disp_drv_t *drv, const lv_area_t *areas, const lv_color_t *const *srcs, uint32_t cnt,
+                         int32_t src_stride, bool last)
+{
+    if (cnt > LV_INV_BUF_SIZE) cnt = LV_INV_BUF_SIZE;
+
+    pthread_mutex_lock(&mutex);
+    while (job_pending) {
+        pthread_cond_wait(&cond, &mutex);
+    }
+
+    job.drv = drv;
+    for(uint32_t i = 0; i < cnt; i++) {
+        job.areas[i] = areas[i];
+        job.srcs[i] = srcs[i];
+    }
+    job.cnt = cnt;
+    job.src_stride = src_stride;
+    job.last = last;
+    job_pending = true;
+
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+}
+
+static void *worker_thread(void *arg)
+{
+    LV_UNUSED(arg);
+
+    pthread_mutex_lock(&mutex);
+    while (true) {
+        while (running && !job_pending) {
+            pthread_cond_wait(&cond, &mutex);
+        }
+        if (!job_pending) break;    // Stopped and nothing left to do
+
+        // The slot stays reserved while transferring, so the job can be used without the lock
+        pthread_mutex_unlock(&mutex);
+
+        for(uint32_t i = 0; i < job.cnt; i++) {
+            transfer_cb(&job.areas[i], job.srcs[i], job.src_stride);
+            simulate_bus_time(lv_area_get_size(&job.areas[i]));
+        }
+
+        // Like a DMA complete interrupt: LVGL may render into this buffer again
+        lv_disp_flush_ready(job.drv);
+        if (done_cb) done_cb(job.last);
+
+        pthread_mutex_lock(&mutex);
+        job_pending = false;
+        pthread_cond_broadcast(&cond);
+    }
+    pthread_mutex_unlock(&mutex);
+
+    return NULL;
+}
+
+/**
+ * Sleep for the time the pixels would take on the panel's serial bus
+ */
+static void simulate_bus_time(uint32_t px)
+{
+#if APP_FLUSH_BUS_HZ > 0
+    uint64_t ns = (uint64_t)px * sizeof(lv_color_t) * 8 * 1000000000ULL / APP_FLUSH_BUS_HZ;
+    struct timespec ts = { (time_t)(ns / 1000000000ULL), (long)(ns % 1000000000ULL) };
+    nanosleep(&ts, NULL);
+#else
+    LV_UNUSED(px);
+#endif
+}
@@ -0,0 +1,45 @@
+/**
+ * @file flush_worker.h
+ * Transfer thread simulating the SPI/DMA path of the panel.
+ * The flush callback hands the rendered areas over and returns immediately,
+ * `lv_disp_flush_ready()` is called by the thread when the transfer is complete.
+ */
+
+#ifndef FLUSH_WORKER_H
+#define FLUSH_WORKER_H
+
+#include "lvgl/lvgl.h"
+#include <stdbool.h>
+
+/*Called on the transfer thread to move one area to the panel*/
+typedef void (*flush_worker_transfer_cb_t)(const lv_area_t *area, const lv_color_t *src, int32_t src_stride);
+
+/*Called on the transfer thread after a job is completed; `last` is true at the end of a refresh*/
+typedef void (*flush_worker_done_cb_t)(bool last);
+
+/**
+ * Start the transfer thread
+ * @param transfer_cb   writes an area to the panel
+ * @param done_cb       notified after every completed job (can be NULL)
+ * @return              false if the thread couldn't be started
+ */
+bool flush_worker_init(flush_worker_transfer_cb_t transfer_cb, flush_worker_done_cb_t done_cb);
+
+/**
+ * Stop the transfer thread after the pending job is completed
+ */
+void flush_worker_deinit(void);
+
+/**
+ * Queue the areas of one flush. Waits if the previous job is still in progress.
+ * @param drv           display driver to signal with `lv_disp_flush_ready()`
+ * @param areas         areas to transfer in screen coordinates (copied)
+ * @param srcs          pointer to the first pixel of each area (the buffers must stay valid until flush ready)
+ * @param cnt           number of areas (can be 0 to only signal flush ready)
+ * @param src_stride    width of the source buffer in pixels
+ * @param last          true if this is the last flush of the refresh
+ */
+void flush_worker_submit(lv_disp_drv_t *drv, const lv_area_t *areas, const lv_color_t *const *srcs, uint32_t cnt,
+                         int32_t src_stride, bool last);
+
+#endif /*FLUSH_WORKER_H*/
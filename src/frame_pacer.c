@@ -0,0 +1,212 @@
+/**
+ * @file frame_pacer.c
+ * Align the LVGL refreshes to the vertical sync of the display
+ */
+
+#include "frame_pacer.h"
+
+#if APP_FRAME_PACER
+
+#include "app_tick.h"
+#include <stdio.h>
+
+// Observed intervals up to this many periods refine the estimate
+#define MAX_VSYNC_GAP 8
+// Frame intervals longer than this many periods are pauses, not jitter
+#define MAX_FRAME_GAP 4
+
+typedef void (*rounder_cb_t)(lv_disp_drv_t *, lv_area_t *);
+
+static lv_disp_t *pacer_disp;
+static rounder_cb_t user_rounder_cb;
+static lv_timer_cb_t user_refr_cb;
+static frame_pacer_rate_cb_t rate_cb;
+
+static uint32_t active_hz;
+static uint32_t period_us;
+static uint64_t last_vsync_us;
+static uint64_t last_frame_us;
+static uint32_t last_active;        /*Tick of the last animation, to detect idle*/
+static uint32_t idle_start;
+static uint64_t jitter_sum;
+static uint32_t jitter_cnt;
+static frame_pacer_stats_t stats;
+
+static void rounder_cb(lv_disp_drv_t *drv, lv_area_t *area);
+static void refr_timer_cb(lv_timer_t *timer);
+static void update_idle(bool anim);
+static void record_frame(uint64_t start, uint64_t end, bool anim);
+static uint64_t next_vsync(uint64_t now);
+static void schedule(lv_timer_t *timer, uint64_t target, uint64_t now);
+
+void frame_pacer_attach(lv_disp_t *disp, uint32_t refresh_hz)
+{
+    pacer_disp = disp;
+    active_hz = refresh_hz ? refresh_hz : APP_FRAME_PACER_DEF_HZ;
+    period_us = 1000000 / active_hz;
+    last_active = lv_tick_get();
+
+    user_rounder_cb = disp->driver->rounder_cb;
+    disp->driver->rounder_cb = rounder_cb;
+
+    user_refr_cb = disp->refr_timer->timer_cb;
+    lv_timer_set_cb(disp->refr_timer, refr_timer_cb);
+}
+
+void frame_pacer_vsync(uint64_t ts_us)
+{
+    stats.vsync_cnt++;
+
+    if (last_vsync_us && ts_us > last_vsync_us) {
+        uint64_t dt = ts_us - last_vsync_us;
+        uint64_t n = (dt + period_us / 2) / period_us;
+        int64_t diff = n ? (int64_t)(dt / n) - (int64_t)period_us : 0;
+
+        // Slowly follow the measured period but ignore presents which didn't wait for the vsync
+        if (n >= 1 && n <= MAX_VSYNC_GAP && (diff < 0 ? -diff : diff) < period_us / 8) {
+            period_us = (uint32_t)((int64_t)period_us + diff / 8);
+        } else {
+            stats.vsync_rejected++;
+        }
+    }
+
+    // The phase always follows the latest vsync
+    last_vsync_us = ts_us;
+}
+
+void frame_pacer_set_rate_cb(frame_pacer_rate_cb_t cb)
+{
+    rate_cb = cb;
+}
+
+void frame_pacer_get_stats(frame_pacer_stats_t *s)
+{
+    *s = stats;
+    s->period_us = period_us;
+    s->jitter_avg_us = jitter_cnt ? (uint32_t)(jitter_sum / jitter_cnt) : 0;
+    if (stats.idle) s->idle_ms += lv_tick_elaps(idle_start);
+}
+
+void frame_pacer_print_stats(void)
+{
+    frame_pacer_stats_t s;
+    frame_pacer_get_stats(&s);
+    uint32_t hz_x100 = s.period_us ? 100000000 / s.period_us : 0;
+
+    printf("[pacer] %u.%02u Hz (%u us), %u frames, jitter avg %u us max %u us, %u late, %u skipped, idle %u ms, %u/%u vsyncs off grid\n",
+           (unsigned)(hz_x100 / 100), (unsigned)(hz_x100 % 100), (unsigned)s.period_us, (unsigned)s.frames,
+           (unsigned)s.jitter_avg_us, (unsigned)s.jitter_max_us, (unsigned)s.late, (unsigned)s.skipped,
+           (unsigned)s.idle_ms, (unsigned)s.vsync_rejected, (unsigned)s.vsync_cnt);
+}
+
+/**
+ * Notice the invalidations and move the next refresh to the next vsync: sooner than the idle
+ * period, and later than right away when LVGL resumes the refresh timer it paused with nothing
+ * to draw (its period elapsed long ago)
+ */
+static void rounder_cb(lv_disp_drv_t *drv, lv_area_t *area)
+{
+    if (user_rounder_cb) user_rounder_cb(drv, area);
+
+    // A running timer is on the grid already while active (see refr_timer_cb())
+    lv_timer_t *timer = pacer_disp->refr_timer;
+    if (!timer->paused && !stats.idle) return;
+
+    uint32_t elapsed = lv_tick_elaps(timer->last_run);
+    uint32_t remaining = timer->period > elapsed ? timer->period - elapsed : 0;
+    uint64_t now = app_tick_get_us();
+    uint64_t target = next_vsync(now);
+
+    if (timer->paused || (target - now + 999) / 1000 < remaining) schedule(timer, target, now);
+}
+
+static void refr_timer_cb(lv_timer_t *timer)
+{
+    bool dirty = pacer_disp->inv_p > 0;
+    bool anim = lv_anim_count_running() > 0;
+
+    uint64_t start = app_tick_get_us();
+    user_refr_cb(timer);
+    uint64_t end = app_tick_get_us();
+
+    update_idle(anim);
+    if (dirty && !stats.idle) record_frame(start, end, anim);
+
+    if (stats.idle) {
+        // Nothing to render until an invalidation pulls the next refresh in
+        lv_timer_reset(timer);
+        lv_timer_set_period(timer, 1000 / APP_FRAME_PACER_IDLE_HZ);
+    } else {
+        schedule(timer, next_vsync(end), end);
+    }
+}
+
+/**
+ * Go idle without animations and input for a while, and active again on either of them
+ */
+static void update_idle(bool anim)
+{
+    if (anim || lv_disp_get_inactive_time(pacer_disp) < APP_FRAME_PACER_IDLE_DELAY) {
+        last_active = lv_tick_get();
+        if (stats.idle) {
+            stats.idle = false;
+            stats.idle_ms += lv_tick_elaps(idle_start);
+            last_frame_us = 0;
+            if (rate_cb) rate_cb(active_hz);
+        }
+    } else if (!stats.idle && lv_tick_elaps(last_active) >= APP_FRAME_PACER_IDLE_DELAY) {
+        stats.idle = true;
+        idle_start = lv_tick_get();
+        if (rate_cb) rate_cb(APP_FRAME_PACER_IDLE_HZ);
+    }
+}
+
+/**
+ * Measure how far the interval from the previous frame is from a whole number of periods
+ */
+static void record_frame(uint64_t start, uint64_t end, bool anim)
+{
+    stats.frames++;
+    if (end > next_vsync(start)) stats.late++;
+
+    if (last_frame_us) {
+        uint64_t interval = start - last_frame_us;
+        uint64_t n = (interval + period_us / 2) / period_us;
+
+        if (n <= MAX_FRAME_GAP) {
+            int64_t dev = (int64_t)interval - (int64_t)(n * period_us);
+            uint32_t jitter = (uint32_t)(dev < 0 ? -dev : dev);
+
+            jitter_sum += jitter;
+            jitter_cnt++;
+            if (jitter > stats.jitter_max_us) stats.jitter_max_us = jitter;
+            if (anim && n > 1) stats.skipped += (uint32_t)(n - 1);
+        }
+    }
+    last_frame_us = start;
+}
+
+/**
+ * Get the first vsync after a time, extrapolated from the last observed one
+ */
+static uint64_t next_vsync(uint64_t now)
+{
+    // No vsync seen yet: any phase is as good as another
+    if (!last_vsync_us) last_vsync_us = now;
+    if (now < last_vsync_us) return last_vsync_us;
+
+    return last_vsync_us + ((now - last_vsync_us) / period_us + 1) * period_us;
+}
+
+/**
+ * Run the refresh timer at `target` (rounded up to the millisecond tick)
+ */
+static void schedule(lv_timer_t *timer, uint64_t target, uint64_t now)
+{
+    uint32_t delay = (uint32_t)((target - now + 999) / 1000);
+
+    lv_timer_reset(timer);
+    lv_timer_set_period(timer, delay ? delay : 1);
+}
+
+#endif /*APP_FRAME_PACER*/
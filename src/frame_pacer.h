@@ -0,0 +1,76 @@
+/**
+ * @file frame_pacer.h
+ * Align the LVGL refreshes to the vertical sync of the display
+ *
+ * LVGL's refresh timer runs with its own `LV_DISP_DEF_REFR_PERIOD`, which
+ * beats against the refresh rate of the display. The pacer instead estimates
+ * the vsync period and phase from the observed vsyncs (present returning with
+ * vsync on the simulator, the TE interrupt on a panel) and schedules every
+ * refresh right after the next vsync, so a frame has a full period to be
+ * rendered and sent before it's shown.
+ *
+ * With no animation and no input for `APP_FRAME_PACER_IDLE_DELAY` ms the
+ * pacer goes idle: the refresh timer only runs when something is invalidated
+ * (e.g. the clock ticking once a second) and the panel can be switched to
+ * `APP_FRAME_PACER_IDLE_HZ` with the rate callback.
+ */
+
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include "lvgl/lvgl.h"
+#include "app_conf.h"
+#include <stdbool.h>
+
+/*Switch the refresh rate of the panel (e.g. its frame rate control register)*/
+typedef void (*frame_pacer_rate_cb_t)(uint32_t hz);
+
+typedef struct {
+    uint32_t period_us;     /*Estimated vsync period*/
+    uint32_t vsync_cnt;     /*Observed vsyncs*/
+    uint32_t vsync_rejected;/*Vsyncs not on the estimated grid (e.g. vsync is not honored)*/
+    uint32_t frames;        /*Refreshes which rendered while active*/
+    uint32_t late;          /*Frames rendered beyond the next vsync*/
+    uint32_t skipped;       /*Vsyncs without a frame while an animation was running*/
+    uint32_t jitter_avg_us; /*Mean deviation of the frame intervals from a multiple of the period*/
+    uint32_t jitter_max_us; /*Largest deviation*/
+    uint32_t idle_ms;       /*Time spent idle*/
+    bool idle;
+} frame_pacer_stats_t;
+
+#if APP_FRAME_PACER
+
+/**
+ * Pace the refreshes of a display: wraps its rounder (to notice new
+ * invalidations) and refresh timer callbacks. Call it after `lv_disp_drv_register()`.
+ * @param disp          the display
+ * @param refresh_hz    nominal refresh rate, the first period estimate (0: `APP_FRAME_PACER_DEF_HZ`)
+ */
+void frame_pacer_attach(lv_disp_t *disp, uint32_t refresh_hz);
+
+/**
+ * Report a vsync, e.g. after a blocking present or from the TE interrupt's timestamp
+ * (call it from the LVGL thread)
+ * @param ts_us         time of the vsync from `app_tick_get_us()`
+ */
+void frame_pacer_vsync(uint64_t ts_us);
+
+/**
+ * Set the callback switching the refresh rate of the panel when going idle or active
+ * @param cb            the callback, NULL if the rate can't be changed
+ */
+void frame_pacer_set_rate_cb(frame_pacer_rate_cb_t cb);
+
+/**
+ * Get the statistics since the attach
+ */
+void frame_pacer_get_stats(frame_pacer_stats_t *stats);
+
+/**
+ * Print the statistics to stdout
+ */
+void frame_pacer_print_stats(void);
+
+#endif /*APP_FRAME_PACER*/
+
+#endif /*FRAME_PACER_H*/
@@ -0,0 +1,115 @@
+/**
+ * @file glyph_cache.c
+ * Pre-rendered glyphs of a small character set
+ */
+
+#include "glyph_cache.h"
+#include <stdlib.h>
+#include <string.h>
+
+static void render_glyph(lv_color_t *buf, lv_coord_t cell_w, lv_coord_t cell_h, const lv_font_t *font,
+                         uint32_t letter, lv_color_t color, lv_color_t bg_color);
+static uint8_t get_glyph_opa(const uint8_t *bitmap, uint32_t px_idx, uint8_t bpp);
+
+bool glyph_cache_init(glyph_cache_t *cache, const lv_font_t *font, const char *chars, lv_coord_t cell_w,
+                      lv_color_t color, lv_color_t bg_color)
+{
+    memset(cache, 0, sizeof(*cache));
+    cache->font = font;
+    cache->h = lv_font_get_line_height(font);
+
+    for(; *chars != '\0' && cache->cnt < GLYPH_CACHE_MAX_CHARS; chars++) {
+        uint32_t letter = (uint32_t)(unsigned char)*chars;
+        lv_coord_t w = cell_w > 0 ? cell_w : (lv_coord_t)lv_font_get_glyph_width(font, letter, 0);
+        uint32_t size = (uint32_t)w * cache->h * sizeof(lv_color_t);
+
+        lv_color_t *buf = malloc(size);
+        if (!buf) {
+            glyph_cache_deinit(cache);
+            return false;
+        }
+        render_glyph(buf, w, cache->h, font, letter, color, bg_color);
+
+        lv_img_dsc_t *img = &cache->imgs[cache->cnt];
+        img->header.always_zero = 0;
+        img->header.cf = LV_IMG_CF_TRUE_COLOR;
+        img->header.w = w;
+        img->header.h = cache->h;
+        img->data_size = size;
+        img->data = (const uint8_t *)buf;
+        cache->chars[cache->cnt] = *chars;
+        cache->cnt++;
+    }
+
+    return true;
+}
+
+void glyph_cache_deinit(glyph_cache_t *cache)
+{
+    for(uint32_t i = 0; i < cache->cnt; i++) {
+        free((void *)cache->imgs[i].data);
+    }
+    cache->cnt = 0;
+}
+
+const lv_img_dsc_t *glyph_cache_get(const glyph_cache_t *cache, char c)
+{
+    for(uint32_t i = 0; i < cache->cnt; i++) {
+        if (cache->chars[i] == c) return &cache->imgs[i];
+    }
+
+    return NULL;
+}
+
+/**
+ * Render a glyph horizontally centered into a cell, at the same position as
+ * a centered one-character label would draw it
+ */
+static void render_glyph(lv_color_t *buf, lv_coord_t cell_w, lv_coord_t cell_h, const lv_font_t *font,
+                         uint32_t letter, lv_color_t color, lv_color_t bg_color)
+{
+    for(uint32_t i = 0; i < (uint32_t)cell_w * cell_h; i++) {
+        buf[i] = bg_color;
+    }
+
+    lv_font_glyph_dsc_t g;
+    if (!lv_font_get_glyph_dsc(font, &g, letter, 0)) return;
+    if (g.box_w == 0 || g.box_h == 0 || g.bpp == 0 || g.bpp > 8) return;
+
+    const uint8_t *bitmap = lv_font_get_glyph_bitmap(g.resolved_font, letter);
+    if (!bitmap) return;
+
+    // Same placement as lv_draw_letter() and the label's centering
+    lv_coord_t x0 = (cell_w - (lv_coord_t)g.adv_w) / 2 + g.ofs_x;
+    lv_coord_t y0 = (font->line_height - font->base_line) - g.box_h - g.ofs_y;
+
+    for(lv_coord_t y = 0; y < (lv_coord_t)g.box_h; y++) {
+        lv_coord_t dy = y0 + y;
+        if (dy < 0 || dy >= cell_h) continue;
+
+        for(lv_coord_t x = 0; x < (lv_coord_t)g.box_w; x++) {
+            lv_coord_t dx = x0 + x;
+            if (dx < 0 || dx >= cell_w) continue;
+
+            uint8_t opa = get_glyph_opa(bitmap, (uint32_t)y * g.box_w + x, g.bpp);
+            if (opa == LV_OPA_TRANSP) continue;
+            buf[dy * cell_w + dx] = lv_color_mix(color, bg_color, opa);
+        }
+    }
+}
+
+/**
+ * Read a pixel of a glyph bitmap. The rows are packed without padding,
+ * most significant bits first.
+ */
+static uint8_t get_glyph_opa(const uint8_t *bitmap, uint32_t px_idx, uint8_t bpp)
+{
+    uint32_t bit_ofs = px_idx * bpp;
+    uint32_t value = 0;
+
+    for(uint8_t b = 0; b < bpp; b++, bit_ofs++) {
+        value = (value << 1) | ((bitmap[bit_ofs >> 3] >> (7 - (bit_ofs & 0x7))) & 0x1);
+    }
+
+    return (uint8_t)(value * 255 / ((1u << bpp) - 1));
+}
@@ -0,0 +1,56 @@
+/**
+ * @file glyph_cache.h
+ * Pre-rendered glyphs of a small character set
+ *
+ * Every glyph is rasterized once into a fixed size cell in the display's color
+ * format, with the text color already blended onto the background color. The
+ * cells are `LV_IMG_CF_TRUE_COLOR` images, so LVGL draws them with plain row
+ * copies instead of the anti-aliased letter path. Only valid on a solid
+ * background of the given color.
+ */
+
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include "lvgl/lvgl.h"
+#include <stdbool.h>
+
+/*Longest character set of a cache*/
+#define GLYPH_CACHE_MAX_CHARS 16
+
+typedef struct {
+    const lv_font_t *font;
+    lv_coord_t h;                                   /*Height of every cell (line height of the font)*/
+    uint32_t cnt;
+    char chars[GLYPH_CACHE_MAX_CHARS];
+    lv_img_dsc_t imgs[GLYPH_CACHE_MAX_CHARS];
+} glyph_cache_t;
+
+/**
+ * Rasterize the glyphs of a character set
+ * @param cache     cache to initialize
+ * @param font      font of the glyphs
+ * @param chars     ASCII characters to render (at most `GLYPH_CACHE_MAX_CHARS`)
+ * @param cell_w    width of the cells, the glyphs are centered in them;
+ *                  0 to use the advance width of each glyph
+ * @param color     text color
+ * @param bg_color  color of the background the cells are shown on
+ * @return          false if the cells couldn't be allocated
+ */
+bool glyph_cache_init(glyph_cache_t *cache, const lv_font_t *font, const char *chars, lv_coord_t cell_w,
+                      lv_color_t color, lv_color_t bg_color);
+
+/**
+ * Free the cells of a cache. Images using them must be deleted first.
+ */
+void glyph_cache_deinit(glyph_cache_t *cache);
+
+/**
+ * Get the cell of a character, to be used as the source of an `lv_img`
+ * @param cache     the cache
+ * @param c         the character
+ * @return          the image descriptor or NULL if the character is not cached
+ */
+const lv_img_dsc_t *glyph_cache_get(const glyph_cache_t *cache, char c);
+
+#endif /*GLYPH_CACHE_H*/
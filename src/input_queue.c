@@ -0,0 +1,94 @@
+/**
+ * @file input_queue.c
+ * Timestamped touch event queue feeding an LVGL pointer input device
+ */
+
+#include "input_queue.h"
+#include <stdatomic.h>
+#include <stdio.h>
+
+#if (APP_INPUT_QUEUE_SIZE & (APP_INPUT_QUEUE_SIZE - 1)) != 0
+#error "APP_INPUT_QUEUE_SIZE must be a power of 2"
+#endif
+
+// Single producer (event loop or interrupt) / single consumer (LVGL) ring buffer
+static input_event_t ring[APP_INPUT_QUEUE_SIZE];
+static atomic_uint ring_head;
+static atomic_uint ring_tail;
+static atomic_uint ring_dropped;
+
+// State of the consumer (only used on the LVGL thread)
+static input_event_t last_ev;
+static uint64_t pending_ts;         /*Oldest event read since the last present, 0: none*/
+static uint64_t latency_sum;
+static input_queue_stats_t stats;
+
+bool input_queue_push(const input_event_t *ev)
+{
+    unsigned head = atomic_load_explicit(&ring_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&ring_tail, memory_order_acquire);
+
+    if (head - tail >= APP_INPUT_QUEUE_SIZE) {
+        atomic_fetch_add_explicit(&ring_dropped, 1, memory_order_relaxed);
+        return false;
+    }
+
+    ring[head & (APP_INPUT_QUEUE_SIZE - 1)] = *ev;
+    atomic_store_explicit(&ring_head, head + 1, memory_order_release);
+
+    return true;
+}
+
+void input_queue_read(lv_indev_drv_t *drv, lv_indev_data_t *data)
+{
+    LV_UNUSED(drv);
+
+    unsigned tail = atomic_load_explicit(&ring_tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&ring_head, memory_order_acquire);
+
+    if (head != tail) {
+        last_ev = ring[tail & (APP_INPUT_QUEUE_SIZE - 1)];
+        atomic_store_explicit(&ring_tail, tail + 1, memory_order_release);
+
+        stats.event_cnt++;
+        if (!pending_ts) pending_ts = last_ev.ts_us;
+    }
+
+    data->point.x = last_ev.x;
+    data->point.y = last_ev.y;
+    data->state = last_ev.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    // Let LVGL call again in the same read to process the rest of the queue
+    data->continue_reading = head - tail > 1;
+}
+
+void input_queue_frame_presented(uint64_t ts_us)
+{
+    if (!pending_ts) return;
+
+    // Events which didn't cause a redraw for a long time are not measured
+    uint64_t latency = ts_us > pending_ts ? ts_us - pending_ts : 0;
+    pending_ts = 0;
+    if (latency > (uint64_t)APP_INPUT_LATENCY_MAX * 1000) return;
+
+    stats.latency_last_us = (uint32_t)latency;
+    if (stats.latency_last_us > stats.latency_max_us) stats.latency_max_us = stats.latency_last_us;
+    latency_sum += latency;
+    stats.latency_cnt++;
+}
+
+void input_queue_get_stats(input_queue_stats_t *s)
+{
+    *s = stats;
+    s->dropped = atomic_load_explicit(&ring_dropped, memory_order_relaxed);
+    s->latency_avg_us = stats.latency_cnt ? (uint32_t)(latency_sum / stats.latency_cnt) : 0;
+}
+
+void input_queue_print_stats(void)
+{
+    input_queue_stats_t s;
+    input_queue_get_stats(&s);
+
+    printf("[input] %u events, %u dropped, input-to-photon avg %u us max %u us (%u samples)\n",
+           (unsigned)s.event_cnt, (unsigned)s.dropped, (unsigned)s.latency_avg_us,
+           (unsigned)s.latency_max_us, (unsigned)s.latency_cnt);
+}
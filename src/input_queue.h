@@ -0,0 +1,67 @@
+/**
+ * @file input_queue.h
+ * Timestamped touch event queue feeding an LVGL pointer input device
+ *
+ * The producer (the SDL event loop on the simulator, the touch controller
+ * interrupt on the board) pushes every press, move and release into a
+ * lock-free single producer/single consumer ring buffer as it happens, so no
+ * tap is lost between two reads. The read callback hands the events to LVGL
+ * one by one in buffered mode (`continue_reading`).
+ * The latency from an event to the first frame presented after LVGL has
+ * processed it (input-to-photon) is measured as well.
+ */
+
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include "lvgl/lvgl.h"
+#include "app_conf.h"
+#include <stdbool.h>
+
+typedef struct {
+    lv_coord_t x;           /*Logical coordinates of the display*/
+    lv_coord_t y;
+    bool pressed;
+    uint64_t ts_us;         /*Time of the event from `app_tick_get_us()`*/
+} input_event_t;
+
+typedef struct {
+    uint32_t event_cnt;     /*Events read by LVGL*/
+    uint32_t dropped;       /*Events dropped because the queue was full*/
+    uint32_t latency_cnt;   /*Latency samples*/
+    uint32_t latency_avg_us;
+    uint32_t latency_max_us;
+    uint32_t latency_last_us;
+} input_queue_stats_t;
+
+/**
+ * Add an event (safe to call from an interrupt or another thread)
+ * @param ev        the event, the coordinates are clamped by LVGL
+ * @return          false if the queue was full and the event was dropped
+ */
+bool input_queue_push(const input_event_t *ev);
+
+/**
+ * LVGL read callback of a pointer input device: pass the oldest event,
+ * or the last state if the queue is empty
+ */
+void input_queue_read(lv_indev_drv_t *drv, lv_indev_data_t *data);
+
+/**
+ * Tell that a frame was presented (call it from the LVGL thread): closes the
+ * latency measurement of the events read since the previous presented frame
+ * @param ts_us     time of the present from `app_tick_get_us()`
+ */
+void input_queue_frame_presented(uint64_t ts_us);
+
+/**
+ * Get the statistics since the start
+ */
+void input_queue_get_stats(input_queue_stats_t *stats);
+
+/**
+ * Print the statistics to stdout
+ */
+void input_queue_print_stats(void);
+
+#endif /*INPUT_QUEUE_H*/
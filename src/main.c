@@ -5,287 +5,375 @@
  */
 
 #include "lvgl/lvgl.h"
+#include "app_conf.h"
+#include "app_mem.h"
+#include "app_theme.h"
+#include "app_tick.h"
+#include "boot_prof.h"
+#include "sdl_display.h"
+#include "splash.h"
+#include "draw_backend.h"
+#include "draw_buf.h"
+#include "flush_sched.h"
+#include "frame_pacer.h"
+#include "input_queue.h"
+#include "par_render.h"
+#include "render_tier.h"
+#include "watch_ui.h"
+#include "telemetry.h"
+#include "timekeeper.h"
+#include "trace.h"
 #include <SDL2/SDL.h>
 #include <stdio.h>
-#include <time.h>
 #include <stdbool.h>
+#include <string.h>
 
-// Display settings for 1.47" screen
-#define SCREEN_WIDTH  172
-#define SCREEN_HEIGHT 320
-
-// SDL window and renderer
-static SDL_Window *window = NULL;
-static SDL_Renderer *renderer = NULL;
-
-// UI objects
-static lv_obj_t *loading_screen = NULL;
-static lv_obj_t *time_screen = NULL;
-static lv_obj_t *time_label = NULL;
-static lv_obj_t *date_label = NULL;
-static lv_timer_t *loading_timer = NULL;
-static lv_timer_t *clock_timer = NULL;
+static lv_indev_t *mouse_indev = NULL;
 
 // Function declarations
-static void create_loading_screen(void);
-static void create_time_screen(void);
-static void loading_timer_cb(lv_timer_t *timer);
-static void clock_update_cb(lv_timer_t *timer);
-static void update_time_display(void);
-static void sdl_display_flush(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p);
-static void sdl_mouse_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data);
-
-/**
- * Create the loading screen with "Welcome" text
- */
-static void create_loading_screen(void)
-{
-    // Create loading screen container
-    loading_screen = lv_obj_create(lv_scr_act());
-    lv_obj_set_size(loading_screen, SCREEN_WIDTH, SCREEN_HEIGHT);
-    lv_obj_set_style_bg_color(loading_screen, lv_color_black(), 0);
-    lv_obj_set_style_border_width(loading_screen, 0, 0);
-    lv_obj_clear_flag(loading_screen, LV_OBJ_FLAG_SCROLLABLE);
-    lv_obj_align(loading_screen, LV_ALIGN_CENTER, 0, 0);
-
-    // Create "Welcome" label
-    lv_obj_t *welcome_label = lv_label_create(loading_screen);
-    lv_label_set_text(welcome_label, "Welcome");
-    lv_obj_set_style_text_color(welcome_label, lv_color_white(), 0);
-    lv_obj_set_style_text_font(welcome_label, &lv_font_montserrat_24, 0);
-    lv_obj_align(welcome_label, LV_ALIGN_CENTER, 0, 0);
-
-    // Create timer to switch to time screen after 4 seconds
-    loading_timer = lv_timer_create(loading_timer_cb, 4000, NULL);
-    lv_timer_set_repeat_count(loading_timer, 1);
-}
+static void sdl_touch_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data);
+static void push_touch(lv_coord_t x, lv_coord_t y, bool pressed);
+static bool handle_sdl_event(const SDL_Event *event);
+#if APP_LOOP_STATS
+static void loop_stats_wakeup(void);
+#endif
 
 /**
- * Create the time display screen
+ * LVGL read callback: pass the queued touch events
  */
-static void create_time_screen(void)
+static void sdl_touch_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
 {
-    // Create time screen container
-    time_screen = lv_obj_create(lv_scr_act());
-    lv_obj_set_size(time_screen, SCREEN_WIDTH, SCREEN_HEIGHT);
-    lv_obj_set_style_bg_color(time_screen, lv_color_black(), 0);
-    lv_obj_set_style_border_width(time_screen, 0, 0);
-    lv_obj_clear_flag(time_screen, LV_OBJ_FLAG_SCROLLABLE);
-    lv_obj_align(time_screen, LV_ALIGN_CENTER, 0, 0);
-    lv_obj_add_flag(time_screen, LV_OBJ_FLAG_HIDDEN); // Hide initially
-
-    // Create time label (HH:MM:SS)
-    time_label = lv_label_create(time_screen);
-    lv_label_set_text(time_label, "00:00:00");
-    lv_obj_set_style_text_color(time_label, lv_color_white(), 0);
-    lv_obj_set_style_text_font(time_label, &lv_font_montserrat_28, 0);
-    lv_obj_align(time_label, LV_ALIGN_CENTER, 0, -20);
-
-    // Create date label
-    date_label = lv_label_create(time_screen);
-    lv_label_set_text(date_label, "");
-    lv_obj_set_style_text_color(date_label, lv_color_make(180, 180, 180), 0);
-    lv_obj_set_style_text_font(date_label, &lv_font_montserrat_14, 0);
-    lv_obj_align(date_label, LV_ALIGN_CENTER, 0, 30);
-
-    // Update time immediately
-    update_time_display();
-
-    // Create timer to update clock every second
-    clock_timer = lv_timer_create(clock_update_cb, 1000, NULL);
-}
-
-/**
- * Timer callback to switch from loading to time screen
- */
-static void loading_timer_cb(lv_timer_t *timer)
-{
-    // Hide loading screen
-    lv_obj_add_flag(loading_screen, LV_OBJ_FLAG_HIDDEN);
-    
-    // Show time screen
-    lv_obj_clear_flag(time_screen, LV_OBJ_FLAG_HIDDEN);
-    
-    printf("Switched to time display\n");
-}
+    input_queue_read(indev_drv, data);
 
-/**
- * Timer callback to update clock display
- */
-static void clock_update_cb(lv_timer_t *timer)
-{
-    update_time_display();
+#if APP_LOOP_MODE == APP_LOOP_WAIT
+    // Nothing to track while released: stop polling until the next event is queued
+    if (data->state == LV_INDEV_STATE_RELEASED && !data->continue_reading) {
+        lv_timer_pause(indev_drv->read_timer);
+    }
+#endif
 }
 
 /**
- * Update the time display with current system time
+ * Queue a touch event (in logical coordinates) as it arrives
  */
-static void update_time_display(void)
+static void push_touch(lv_coord_t x, lv_coord_t y, bool pressed)
 {
-    time_t now;
-    struct tm *timeinfo;
-    char time_str[32];
-    char date_str[64];
-
-    // Get current time
-    time(&now);
-    timeinfo = localtime(&now);
-
-    // Format time (HH:MM:SS)
-    strftime(time_str, sizeof(time_str), "%H:%M:%S", timeinfo);
-    lv_label_set_text(time_label, time_str);
-
-    // Format date (Day, Mon DD YYYY)
-    strftime(date_str, sizeof(date_str), "%a, %b %d %Y", timeinfo);
-    lv_label_set_text(date_label, date_str);
+    input_event_t ev = { x, y, pressed, app_tick_get_us() };
+    input_queue_push(&ev);
+#if APP_TRACE
+    trace_capture_input(x, y, pressed);
+#endif
+#if APP_AOD
+    watch_ui_wake();
+#endif
+
+    // Read the queue in the next lv_timer_handler() call instead of waiting for the read period
+    lv_timer_resume(mouse_indev->driver->read_timer);
+    lv_timer_ready(mouse_indev->driver->read_timer);
 }
 
 /**
- * SDL display flush callback
+ * Handle one SDL event
+ * @return true if the application should quit
  */
-static void sdl_display_flush(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p)
+static bool handle_sdl_event(const SDL_Event *event)
 {
-    // Update pixels in the specified area
-    for(int y = area->y1; y <= area->y2; y++) {
-        for(int x = area->x1; x <= area->x2; x++) {
-            int idx = (y - area->y1) * (area->x2 - area->x1 + 1) + (x - area->x1);
-            lv_color_t c = color_p[idx];
-            
-            SDL_SetRenderDrawColor(renderer, 
-                LV_COLOR_GET_R(c) << 3,  // 5-bit to 8-bit
-                LV_COLOR_GET_G(c) << 2,  // 6-bit to 8-bit
-                LV_COLOR_GET_B(c) << 3,  // 5-bit to 8-bit
-                0xFF);
-            SDL_RenderDrawPoint(renderer, x, y);
+    switch (event->type) {
+    case SDL_QUIT:
+        return true;
+    case SDL_WINDOWEVENT:
+        // The window content was lost, present the panel texture again
+        if (event->window.event == SDL_WINDOWEVENT_EXPOSED ||
+            event->window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+            sdl_display_invalidate();
+        }
+        break;
+#if APP_TELEMETRY
+    case SDL_KEYDOWN:
+        if (event->key.keysym.sym == SDLK_t) telemetry_toggle_overlay();
+        break;
+#endif
+    // The renderer's logical size already maps the mouse coordinates from the zoomed window.
+    // Touches also emulate the mouse: only their finger events are used.
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+        if (event->button.button == SDL_BUTTON_LEFT && event->button.which != SDL_TOUCH_MOUSEID) {
+            push_touch(event->button.x, event->button.y, event->type == SDL_MOUSEBUTTONDOWN);
+        }
+        break;
+    case SDL_MOUSEMOTION:
+        if ((event->motion.state & SDL_BUTTON_LMASK) && event->motion.which != SDL_TOUCH_MOUSEID) {
+            push_touch(event->motion.x, event->motion.y, true);
         }
+        break;
+    case SDL_FINGERDOWN:
+    case SDL_FINGERMOTION:
+    case SDL_FINGERUP:
+        // Normalized to the logical size
+        push_touch((lv_coord_t)(event->tfinger.x * SCREEN_WIDTH), (lv_coord_t)(event->tfinger.y * SCREEN_HEIGHT),
+                   event->type != SDL_FINGERUP);
+        break;
+    default:
+        break;
     }
 
-    lv_disp_flush_ready(disp_drv);
+    return false;
 }
 
+#if APP_LOOP_STATS
 /**
- * SDL mouse read callback
+ * Count a main loop wakeup and print the rate once per second
  */
-static void sdl_mouse_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
+static void loop_stats_wakeup(void)
 {
-    int x, y;
-    uint32_t mouse_state = SDL_GetMouseState(&x, &y);
-    
-    // Scale mouse coordinates back to logical size
-    SDL_RenderGetLogicalSize(renderer, NULL, NULL);
-    
-    if(mouse_state & SDL_BUTTON_LMASK) {
-        data->state = LV_INDEV_STATE_PRESSED;
-    } else {
-        data->state = LV_INDEV_STATE_RELEASED;
+    static uint32_t wakeup_cnt;
+    static uint32_t period_start;
+
+    wakeup_cnt++;
+
+    uint32_t elapsed = lv_tick_elaps(period_start);
+    if (elapsed >= 1000) {
+        printf("[loop] %u wakeups/s\n", (unsigned)(wakeup_cnt * 1000 / elapsed));
+        wakeup_cnt = 0;
+        period_start = lv_tick_get();
     }
-    
-    data->point.x = x;
-    data->point.y = y;
 }
+#endif
 
 /**
  * Main function
  */
 int main(int argc, char **argv)
 {
-    printf("Starting LVGL Watch Application...\n");
-    printf("Target display: 1.47\" (%dx%d)\n", SCREEN_WIDTH, SCREEN_HEIGHT);
-
-    // Initialize SDL2
-    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
-        printf("SDL_Init Error: %s\n", SDL_GetError());
+    draw_buf_mode_t buf_mode = APP_DRAW_BUF_MODE;
+    uint32_t buf_lines = APP_DRAW_BUF_LINES;
+    draw_backend_t backend = APP_DRAW_BACKEND;
+    bool minimal_theme = APP_THEME_MINIMAL;
+    render_tier_t tier = APP_RENDER_TIER;
+#if APP_TELEMETRY
+    const char *csv_path = NULL;
+#endif
+#if APP_TRACE
+    const char *trace_path = NULL;
+#endif
+
+    boot_prof_mark("start");
+
+    // Parse command line options
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--buf=", 6) == 0 && draw_buf_parse(argv[i] + 6, &buf_mode, &buf_lines)) {
+            continue;
+        }
+        if (strncmp(argv[i], "--draw=", 7) == 0 && draw_backend_parse(argv[i] + 7, &backend)) {
+            continue;
+        }
+        if (strncmp(argv[i], "--theme=", 8) == 0 && app_theme_parse(argv[i] + 8, &minimal_theme)) {
+            continue;
+        }
+        if (strncmp(argv[i], "--render=", 9) == 0 && render_tier_parse(argv[i] + 9, &tier)) {
+            continue;
+        }
+#if APP_TELEMETRY
+        if (strncmp(argv[i], "--telemetry-csv=", 16) == 0) {
+            csv_path = argv[i] + 16;
+            continue;
+        }
+#endif
+#if APP_TRACE
+        if (strncmp(argv[i], "--record=", 9) == 0) {
+            trace_path = argv[i] + 9;
+            continue;
+        }
+#endif
+        printf("Usage: %s [--buf=partial[:lines]|full|full-refresh|direct|direct-fb] [--draw=auto|sw|sw-bands|dma2d|arm2d|pxp] [--theme=default|minimal] [--render=full|fast]%s%s\n", argv[0],
+               APP_TELEMETRY ? " [--telemetry-csv=file]" : "", APP_TRACE ? " [--record=file]" : "");
         return 1;
     }
 
-    // Create SDL window
-    window = SDL_CreateWindow("LVGL Watch Simulator",
-                              SDL_WINDOWPOS_CENTERED,
-                              SDL_WINDOWPOS_CENTERED,
-                              SCREEN_WIDTH * 2,  // Scale 2x for easier viewing
-                              SCREEN_HEIGHT * 2,
-                              SDL_WINDOW_SHOWN);
-    if (!window) {
-        printf("SDL_CreateWindow Error: %s\n", SDL_GetError());
-        SDL_Quit();
-        return 1;
-    }
+    printf("Starting LVGL Watch Application...\n");
+    printf("Target display: %s\n", APP_DISPLAY_NAME);
 
-    // Create SDL renderer
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
-    if (!renderer) {
-        printf("SDL_CreateRenderer Error: %s\n", SDL_GetError());
-        SDL_DestroyWindow(window);
-        SDL_Quit();
+    // Initialize SDL2 window, renderer and panel texture
+    if (!sdl_display_init(SCREEN_WIDTH, SCREEN_HEIGHT, APP_SDL_ZOOM)) {
         return 1;
     }
-
-    // Enable logical size to match display resolution
-    SDL_RenderSetLogicalSize(renderer, SCREEN_WIDTH, SCREEN_HEIGHT);
+    boot_prof_mark("sdl init");
+
+#if APP_SPLASH
+    // Show the pre-rendered splash right away, LVGL starts with it on the panel
+    lv_color_t *panel = sdl_display_get_fb();
+    bool splash_shown = panel && splash_decode(splash_blob, splash_blob_size, (uint16_t *)panel,
+                                               SCREEN_WIDTH, SCREEN_HEIGHT);
+    if (splash_shown) {
+        sdl_display_fb_changed(NULL);
+        sdl_display_present();
+        boot_prof_first_pixel();
+        watch_ui_set_prerendered_splash(true);
+    } else {
+        printf("Invalid splash, rendering it with LVGL\n");
+    }
+#else
+    bool splash_shown = false;
+#endif
 
     // Initialize LVGL
     lv_init();
+    boot_prof_mark("lv_init");
+
+    // With direct-fb LVGL renders into the memory the panel texture is uploaded from
+    if (buf_mode == DRAW_BUF_DIRECT_FB) {
+        lv_color_t *fb = sdl_display_get_fb();
+        if (!fb) {
+            sdl_display_deinit();
+            return 1;
+        }
+        draw_buf_set_panel_fb(fb);
+    }
 
-    // Create display buffer
-    static lv_color_t buf1[SCREEN_WIDTH * 10];
-    static lv_color_t buf2[SCREEN_WIDTH * 10];
-    static lv_disp_draw_buf_t disp_buf;
-    lv_disp_draw_buf_init(&disp_buf, buf1, buf2, SCREEN_WIDTH * 10);
+#if APP_PAR_RENDER
+    // Workers for the large blends and conversions, LVGL itself stays on this thread
+    par_render_init(APP_PAR_RENDER_THREADS);
+    printf("Render threads: %u\n", (unsigned)par_render_get_thread_cnt());
+#endif
 
-    // Register display driver
+    // Register display driver with the selected draw buffers
     static lv_disp_drv_t disp_drv;
     lv_disp_drv_init(&disp_drv);
-    disp_drv.draw_buf = &disp_buf;
     disp_drv.flush_cb = sdl_display_flush;
+    backend = draw_backend_setup(&disp_drv, backend);
     disp_drv.hor_res = SCREEN_WIDTH;
     disp_drv.ver_res = SCREEN_HEIGHT;
-    lv_disp_drv_register(&disp_drv);
+    if (!draw_buf_setup(&disp_drv, buf_mode, buf_lines)) {
+        sdl_display_deinit();
+        return 1;
+    }
+    lv_disp_t *disp = lv_disp_drv_register(&disp_drv);
+    app_theme_init(disp, minimal_theme);
+    render_tier_setup(disp, tier);
+    printf("Draw buffers: %s\n", draw_buf_mode_name(buf_mode));
+    printf("Draw backend: %s\n", draw_backend_name(backend));
+    printf("Theme: %s\n", minimal_theme ? "minimal" : "default");
+    printf("Render tier: %s\n", render_tier_name(tier));
+
+#if APP_FLUSH_SCHED
+    flush_sched_attach(disp);
+#endif
+
+#if APP_FRAME_PACER
+    // Refresh right after the vsyncs reported by the presents below
+    frame_pacer_attach(disp, (uint32_t)sdl_display_get_refresh_hz());
+#endif
+
+#if APP_TELEMETRY
+    // Record every frame, press 'T' to show the overlay
+    telemetry_attach(disp);
+    if (csv_path) telemetry_set_csv(csv_path);
+#endif
+
+    boot_prof_mark("display driver");
+
+#if APP_TRACE
+    // Record everything the frames depend on from here, replay it with lvgl_watch_replay
+    if (trace_path) {
+        trace_header_t hdr = { SCREEN_WIDTH, SCREEN_HEIGHT, lv_tick_get(), splash_shown ? TRACE_FLAG_SPLASH : 0 };
+        if (trace_capture_start(trace_path, &hdr)) {
+            timekeeper_set_rtc(trace_capture_time);
+            printf("Recording to %s\n", trace_path);
+        }
+    }
+#endif
+
+#if APP_AOD
+    // Switch the panel to its idle mode in the always-on mode
+    watch_ui_set_aod_cb(sdl_display_set_idle_mode);
+#endif
+
+    // Show the loading screen, the time screen is built in the background
+    watch_ui_create();
+    boot_prof_mark("loading screen");
+
+    // Render and show the welcome frame before initializing the rest
+    if (!splash_shown) {
+        lv_refr_now(disp);
+        for (int i = 0; i < 100 && !sdl_display_present(); i++) {
+            SDL_Delay(1);   // the transfer thread may still be sending it
+        }
+        boot_prof_first_pixel();
+    }
 
-    // Register input device (mouse for emulator)
+    // Register input device (mouse or touch events of the emulator, buffered in input_queue)
     static lv_indev_drv_t indev_drv;
     lv_indev_drv_init(&indev_drv);
     indev_drv.type = LV_INDEV_TYPE_POINTER;
-    indev_drv.read_cb = sdl_mouse_read;
-    lv_indev_drv_register(&indev_drv);
-
-    // Create loading screen first
-    create_loading_screen();
-    
-    // Create time screen (hidden initially)
-    create_time_screen();
+    indev_drv.read_cb = sdl_touch_read;
+    mouse_indev = lv_indev_drv_register(&indev_drv);
+    boot_prof_mark("input device");
 
     printf("Loading screen displayed. Will switch to time in 4 seconds...\n");
+    boot_prof_report();
 
     // Main loop
     SDL_Event event;
     bool quit = false;
     
     while (!quit) {
+#if APP_LOOP_STATS
+        loop_stats_wakeup();
+#endif
+
         // Handle SDL events
         while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                quit = true;
-            }
+            quit |= handle_sdl_event(&event);
         }
 
-        // Clear screen
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);
-
         // Handle LVGL tasks
-        lv_timer_handler();
+#if APP_TRACE
+        trace_capture_step(lv_tick_get());
+#endif
+        uint32_t idle_ms = telemetry_timer_handler();
+
+        // Present frame (only if LVGL has rendered something), with vsync it returns on the vsync
+        if (sdl_display_present()) {
+            uint64_t present_us = app_tick_get_us();
+            input_queue_frame_presented(present_us);
+#if APP_FRAME_PACER
+            frame_pacer_vsync(present_us);
+#endif
+        }
 
-        // Present frame
-        SDL_RenderPresent(renderer);
+#if APP_LOOP_MODE == APP_LOOP_WAIT
+        // Sleep until the next LVGL timer is due or an event arrives
+        if (idle_ms > APP_LOOP_MAX_WAIT) idle_ms = APP_LOOP_MAX_WAIT;
+        if (idle_ms > 0 && SDL_WaitEventTimeout(&event, (int)idle_ms)) {
+            quit |= handle_sdl_event(&event);
+        }
+#else
+        LV_UNUSED(idle_ms);
 
         // Small delay
-        SDL_Delay(5);
+        SDL_Delay(APP_LOOP_POLL_DELAY);
+#endif
     }
 
     // Cleanup
-    SDL_DestroyRenderer(renderer);
-    SDL_DestroyWindow(window);
-    SDL_Quit();
+#if APP_TELEMETRY
+    telemetry_dump();
+    telemetry_set_csv(NULL);
+#endif
+#if APP_TRACE
+    trace_capture_stop();
+#endif
+    input_queue_print_stats();
+#if APP_FRAME_PACER
+    frame_pacer_print_stats();
+#endif
+#if APP_MEM_CUSTOM
+    app_mem_print_stats();
+#endif
+    sdl_display_deinit();
+#if APP_PAR_RENDER
+    par_render_deinit();
+#endif
 
     printf("Application closed.\n");
 
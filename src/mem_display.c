@@ -0,0 +1,77 @@
+/**
+ * @file mem_display.c
+ * Headless display backend: the flushed areas are copied into a framebuffer in RAM
+ */
+
+#include "mem_display.h"
+#include "draw_buf.h"
+#include <stdlib.h>
+#include <string.h>
+
+static lv_color_t *fb = NULL;
+static lv_coord_t fb_w;
+static mem_display_stats_t stats;
+
+bool mem_display_init(lv_coord_t hor_res, lv_coord_t ver_res)
+{
+    fb_w = hor_res;
+    fb = calloc((size_t)hor_res * ver_res, sizeof(lv_color_t));
+    mem_display_reset_stats();
+
+    return fb != NULL;
+}
+
+void mem_display_deinit(void)
+{
+    free(fb);
+    fb = NULL;
+}
+
+void mem_display_flush(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    lv_area_t areas[LV_INV_BUF_SIZE];
+    const lv_color_t *srcs[LV_INV_BUF_SIZE];
+    int32_t stride;
+    uint32_t cnt = draw_buf_get_flush_areas(disp_drv, area, color_p, areas, srcs, &stride);
+
+    // Rendered straight into the framebuffer
+    if (color_p == fb) {
+        stats.area_cnt += cnt;
+        stats.flush_cnt++;
+        lv_disp_flush_ready(disp_drv);
+        return;
+    }
+
+    for(uint32_t i = 0; i < cnt; i++) {
+        const lv_color_t *src = srcs[i];
+        lv_color_t *dst = fb + areas[i].y1 * fb_w + areas[i].x1;
+        size_t row_size = (size_t)lv_area_get_width(&areas[i]) * sizeof(lv_color_t);
+
+        for(int32_t y = areas[i].y1; y <= areas[i].y2; y++) {
+            memcpy(dst, src, row_size);
+            src += stride;
+            dst += fb_w;
+        }
+
+        stats.area_cnt++;
+        stats.flush_bytes += (uint64_t)lv_area_get_size(&areas[i]) * sizeof(lv_color_t);
+    }
+    stats.flush_cnt++;
+
+    lv_disp_flush_ready(disp_drv);
+}
+
+lv_color_t *mem_display_get_fb(void)
+{
+    return fb;
+}
+
+mem_display_stats_t mem_display_get_stats(void)
+{
+    return stats;
+}
+
+void mem_display_reset_stats(void)
+{
+    memset(&stats, 0, sizeof(stats));
+}
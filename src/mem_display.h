@@ -0,0 +1,52 @@
+/**
+ * @file mem_display.h
+ * Headless display backend: the flushed areas are copied into a framebuffer in RAM
+ */
+
+#ifndef MEM_DISPLAY_H
+#define MEM_DISPLAY_H
+
+#include "lvgl/lvgl.h"
+#include <stdbool.h>
+
+typedef struct {
+    uint32_t flush_cnt;     /*Number of flush callback calls*/
+    uint32_t area_cnt;      /*Number of areas written to the framebuffer*/
+    uint64_t flush_bytes;   /*Bytes copied to the framebuffer*/
+} mem_display_stats_t;
+
+/**
+ * Allocate the framebuffer
+ * @param hor_res   horizontal resolution
+ * @param ver_res   vertical resolution
+ * @return          false if the framebuffer couldn't be allocated
+ */
+bool mem_display_init(lv_coord_t hor_res, lv_coord_t ver_res);
+
+/**
+ * Free the framebuffer
+ */
+void mem_display_deinit(void);
+
+/**
+ * LVGL flush callback: copy the rendered area into the framebuffer
+ * (nothing to copy if LVGL renders into it with `DRAW_BUF_DIRECT_FB`)
+ */
+void mem_display_flush(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p);
+
+/**
+ * Get the framebuffer (`hor_res * ver_res` pixels), also to be used with `draw_buf_set_panel_fb()`
+ */
+lv_color_t *mem_display_get_fb(void);
+
+/**
+ * Get the statistics collected since init or the last reset
+ */
+mem_display_stats_t mem_display_get_stats(void);
+
+/**
+ * Clear the statistics
+ */
+void mem_display_reset_stats(void);
+
+#endif /*MEM_DISPLAY_H*/
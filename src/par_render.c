@@ -0,0 +1,196 @@
+/**
+ * @file par_render.c
+ * Worker pool running the pixel work of a frame in horizontal bands
+ */
+
+#include "par_render.h"
+
+#if APP_PAR_RENDER
+
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+
+typedef void (*blend_cb_t)(lv_draw_ctx_t *, const lv_draw_sw_blend_dsc_t *);
+
+typedef struct {
+    lv_draw_ctx_t *draw_ctx;
+    const lv_draw_sw_blend_dsc_t *dsc;
+    lv_area_t area;                 /*The blended area clipped to the draw context*/
+} blend_job_t;
+
+static pthread_t threads[APP_PAR_RENDER_MAX_THREADS];
+static uint32_t thread_cnt = 1;     /*Including the caller of par_render_run()*/
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t start_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t done_cond = PTHREAD_COND_INITIALIZER;
+static pthread_mutex_t run_mutex = PTHREAD_MUTEX_INITIALIZER;
+static bool quit;
+
+// The job in progress (protected by `mutex`)
+static par_render_job_cb_t job_cb;
+static void *job_user_data;
+static uint32_t job_cnt;
+static uint32_t job_next;
+static uint32_t job_remaining;
+
+static blend_cb_t sw_blend;
+
+static void *worker_thread(void *arg);
+static bool run_next(void);
+static void blend(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc);
+static void blend_band(void *user_data, uint32_t idx, uint32_t cnt);
+
+bool par_render_init(uint32_t cnt)
+{
+    if (cnt == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        cnt = cpus > 0 ? (uint32_t)cpus : 1;
+    }
+    if (cnt > APP_PAR_RENDER_MAX_THREADS) cnt = APP_PAR_RENDER_MAX_THREADS;
+
+    quit = false;
+    thread_cnt = 1;
+    for(uint32_t i = 1; i < cnt; i++) {
+        if (pthread_create(&threads[i], NULL, worker_thread, NULL) != 0) {
+            printf("Can't start render worker %u\n", (unsigned)i);
+            par_render_deinit();
+            return false;
+        }
+        thread_cnt++;
+    }
+
+    return true;
+}
+
+void par_render_deinit(void)
+{
+    pthread_mutex_lock(&mutex);
+    quit = true;
+    pthread_cond_broadcast(&start_cond);
+    pthread_mutex_unlock(&mutex);
+
+    for(uint32_t i = 1; i < thread_cnt; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    thread_cnt = 1;
+}
+
+uint32_t par_render_get_thread_cnt(void)
+{
+    return thread_cnt;
+}
+
+void par_render_run(par_render_job_cb_t cb, void *user_data, uint32_t cnt)
+{
+    if (cnt <= 1 || thread_cnt <= 1) {
+        for(uint32_t i = 0; i < cnt; i++) cb(user_data, i, cnt);
+        return;
+    }
+
+    // One job at a time, e.g. if the backend converts on another thread than LVGL
+    pthread_mutex_lock(&run_mutex);
+
+    pthread_mutex_lock(&mutex);
+    job_cb = cb;
+    job_user_data = user_data;
+    job_cnt = cnt;
+    job_next = 0;
+    job_remaining = cnt;
+    pthread_cond_broadcast(&start_cond);
+
+    // Take bands too instead of only waiting
+    while (run_next()) {}
+    while (job_remaining > 0) pthread_cond_wait(&done_cond, &mutex);
+    pthread_mutex_unlock(&mutex);
+
+    pthread_mutex_unlock(&run_mutex);
+}
+
+void par_render_draw_ctx_init(lv_disp_drv_t *drv, lv_draw_ctx_t *draw_ctx)
+{
+    lv_draw_sw_init_ctx(drv, draw_ctx);
+
+    lv_draw_sw_ctx_t *sw_ctx = (lv_draw_sw_ctx_t *)draw_ctx;
+    sw_blend = sw_ctx->blend;
+    sw_ctx->blend = blend;
+}
+
+static void *worker_thread(void *arg)
+{
+    LV_UNUSED(arg);
+
+    pthread_mutex_lock(&mutex);
+    while (!quit) {
+        if (!run_next()) pthread_cond_wait(&start_cond, &mutex);
+    }
+    pthread_mutex_unlock(&mutex);
+
+    return NULL;
+}
+
+/**
+ * Run the next band of the job if there is one (called with `mutex` locked)
+ * @return          false if every band was taken already
+ */
+static bool run_next(void)
+{
+    if (job_next >= job_cnt) return false;
+
+    uint32_t idx = job_next++;
+    par_render_job_cb_t cb = job_cb;
+    void *user_data = job_user_data;
+    uint32_t cnt = job_cnt;
+
+    pthread_mutex_unlock(&mutex);
+    cb(user_data, idx, cnt);
+    pthread_mutex_lock(&mutex);
+
+    if (--job_remaining == 0) pthread_cond_signal(&done_cond);
+
+    return true;
+}
+
+/**
+ * Blend callback of the software renderer: split the large blends into bands
+ */
+static void blend(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc)
+{
+    blend_job_t job = { draw_ctx, dsc, { 0 } };
+    const lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+
+    if (!_lv_area_intersect(&job.area, dsc->blend_area, draw_ctx->clip_area)) return;
+
+    uint32_t band_cnt = (uint32_t)lv_area_get_height(&job.area) / APP_PAR_RENDER_MIN_ROWS;
+    if (band_cnt > thread_cnt) band_cnt = thread_cnt;
+
+    // Small blends don't pay for waking the workers, and set_px_cb may not be thread safe
+    if (band_cnt <= 1 || lv_area_get_size(&job.area) < APP_PAR_RENDER_MIN_PX ||
+        (dsc->mask_buf && dsc->mask_res == LV_DRAW_MASK_RES_TRANSP) || disp->driver->set_px_cb) {
+        sw_blend(draw_ctx, dsc);
+        return;
+    }
+
+    par_render_run(blend_band, &job, band_cnt);
+}
+
+/**
+ * Blend one band: the same blend with the clip area limited to the band's rows
+ */
+static void blend_band(void *user_data, uint32_t idx, uint32_t cnt)
+{
+    const blend_job_t *job = user_data;
+    int32_t h = lv_area_get_height(&job->area);
+    lv_area_t clip = job->area;
+
+    clip.y1 = (lv_coord_t)(job->area.y1 + h * (int32_t)idx / (int32_t)cnt);
+    clip.y2 = (lv_coord_t)(job->area.y1 + h * (int32_t)(idx + 1) / (int32_t)cnt - 1);
+
+    // Each band gets its own copy of the context, only the clip area differs
+    lv_draw_sw_ctx_t band_ctx = *(lv_draw_sw_ctx_t *)job->draw_ctx;
+    band_ctx.base_draw.clip_area = &clip;
+
+    sw_blend((lv_draw_ctx_t *)&band_ctx, job->dsc);
+}
+
+#endif /*APP_PAR_RENDER*/
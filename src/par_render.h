@@ -0,0 +1,61 @@
+/**
+ * @file par_render.h
+ * Worker pool running the pixel work of a frame in horizontal bands
+ *
+ * LVGL itself (object tree, styles, masks, `lv_mem`, font and image caches)
+ * is not thread safe, so the refresh keeps running on the LVGL thread.
+ * What is parallelized is the pixel work below it:
+ * - every large blend of the software renderer (fills of backgrounds, image
+ *   and glyph maps) is split into bands of rows which the pool blends
+ *   concurrently into the same draw buffer; the LVGL thread takes a band too
+ *   and waits for all of them, so for LVGL the blend is still synchronous,
+ * - the display backend can convert a flushed area in bands the same way.
+ * The bands never overlap, and they are flushed in order by LVGL as before.
+ */
+
+#ifndef PAR_RENDER_H
+#define PAR_RENDER_H
+
+#include "lvgl/lvgl.h"
+#include "app_conf.h"
+#include <stdbool.h>
+
+/*Process band `idx` of `cnt`*/
+typedef void (*par_render_job_cb_t)(void *user_data, uint32_t idx, uint32_t cnt);
+
+#if APP_PAR_RENDER
+
+/**
+ * Start the worker threads
+ * @param thread_cnt    number of threads including the caller (0: one per CPU), 1 runs every job inline
+ * @return              false if the threads couldn't be started (the jobs then run inline)
+ */
+bool par_render_init(uint32_t thread_cnt);
+
+/**
+ * Stop the worker threads
+ */
+void par_render_deinit(void);
+
+/**
+ * Get the number of threads running the bands, including the caller
+ */
+uint32_t par_render_get_thread_cnt(void);
+
+/**
+ * Run `cnt` bands on the pool and the calling thread and wait until all are done
+ * @param cb            processes one band
+ * @param user_data     passed to `cb`
+ * @param cnt           number of bands, e.g. `par_render_get_thread_cnt()`
+ */
+void par_render_run(par_render_job_cb_t cb, void *user_data, uint32_t cnt);
+
+/**
+ * Draw context init callback (`lv_disp_drv_t.draw_ctx_init`): the software
+ * renderer with its large blends split into bands on the pool
+ */
+void par_render_draw_ctx_init(lv_disp_drv_t *drv, lv_draw_ctx_t *draw_ctx);
+
+#endif /*APP_PAR_RENDER*/
+
+#endif /*PAR_RENDER_H*/
@@ -0,0 +1,239 @@
+/**
+ * @file pixel_conv.c
+ * RGB565 to ARGB8888 conversion of pixel rows
+ */
+
+#include "pixel_conv.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PIXEL_CONV_X86 1
+#include <immintrin.h>
+#elif defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+#define PIXEL_CONV_MVE 1
+#include <arm_mve.h>
+#elif defined(__ARM_NEON)
+#define PIXEL_CONV_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if PIXEL_CONV_X86 && (defined(__GNUC__) || defined(__clang__))
+// AVX2 code is compiled with a function attribute and only called if the CPU has it
+#define PIXEL_CONV_AVX2 1
+#endif
+
+static void conv_scalar(uint32_t *dst, const uint16_t *src, uint32_t px_cnt);
+#if PIXEL_CONV_X86
+static void conv_sse2(uint32_t *dst, const uint16_t *src, uint32_t px_cnt);
+#endif
+#if PIXEL_CONV_AVX2
+static void conv_avx2(uint32_t *dst, const uint16_t *src, uint32_t px_cnt);
+#endif
+#if PIXEL_CONV_NEON
+static void conv_neon(uint32_t *dst, const uint16_t *src, uint32_t px_cnt);
+#endif
+#if PIXEL_CONV_MVE
+static void conv_mve(uint32_t *dst, const uint16_t *src, uint32_t px_cnt);
+#endif
+static void conv_first(uint32_t *dst, const uint16_t *src, uint32_t px_cnt);
+
+// The usable kernels are put in the front of the table on the first call
+static pixel_conv_impl_t impls[] = {
+    { "scalar", conv_scalar },
+#if PIXEL_CONV_X86
+    { "sse2", conv_sse2 },
+#endif
+#if PIXEL_CONV_AVX2
+    { "avx2", conv_avx2 },
+#endif
+#if PIXEL_CONV_NEON
+    { "neon", conv_neon },
+#endif
+#if PIXEL_CONV_MVE
+    { "helium", conv_mve },
+#endif
+};
+static uint32_t impl_cnt;
+static const pixel_conv_impl_t *impl_act;
+static pixel_conv_cb_t conv_act = conv_first;
+
+static void select_impl(void);
+
+void pixel_conv_rgb565_to_argb8888(uint32_t *dst, const uint16_t *src, uint32_t px_cnt)
+{
+    conv_act(dst, src, px_cnt);
+}
+
+const pixel_conv_impl_t *pixel_conv_get_impls(uint32_t *cnt)
+{
+    select_impl();
+    *cnt = impl_cnt;
+
+    return impls;
+}
+
+const pixel_conv_impl_t *pixel_conv_get_impl(void)
+{
+    select_impl();
+
+    return impl_act;
+}
+
+/**
+ * Drop the kernels the CPU doesn't support and take the last (fastest) one
+ */
+static void select_impl(void)
+{
+    if (impl_act) return;
+
+    uint32_t cnt = 0;
+    for(uint32_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+#if PIXEL_CONV_AVX2
+        if (impls[i].cb == conv_avx2 && !__builtin_cpu_supports("avx2")) continue;
+#endif
+        impls[cnt++] = impls[i];
+    }
+
+    impl_cnt = cnt;
+    impl_act = &impls[cnt - 1];
+    conv_act = impl_act->cb;
+}
+
+/**
+ * Select the kernel on the first conversion
+ */
+static void conv_first(uint32_t *dst, const uint16_t *src, uint32_t px_cnt)
+{
+    select_impl();
+    conv_act(dst, src, px_cnt);
+}
+
+static void conv_scalar(uint32_t *dst, const uint16_t *src, uint32_t px_cnt)
+{
+    for(uint32_t i = 0; i < px_cnt; i++) {
+        dst[i] = pixel_conv_rgb565_px(src[i]);
+    }
+}
+
+/* The vector kernels work on 16 bit lanes: every pixel is split into
+ * (G << 8 | B) and (0xFF << 8 | R), and the two halves are interleaved
+ * into the 32 bit output words. */
+
+#if PIXEL_CONV_X86
+static void conv_sse2(uint32_t *dst, const uint16_t *src, uint32_t px_cnt)
+{
+    const __m128i mask5 = _mm_set1_epi16(0x1F);
+    const __m128i mask6 = _mm_set1_epi16(0x3F);
+    const __m128i alpha = _mm_set1_epi16((short)0xFF00);
+    uint32_t i = 0;
+
+    for(; i + 8 <= px_cnt; i += 8) {
+        __m128i c = _mm_loadu_si128((const __m128i *)(src + i));
+
+        __m128i r = _mm_and_si128(_mm_srli_epi16(c, 11), mask5);
+        __m128i g = _mm_and_si128(_mm_srli_epi16(c, 5), mask6);
+        __m128i b = _mm_and_si128(c, mask5);
+
+        r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+        g = _mm_or_si128(_mm_slli_epi16(g, 2), _mm_srli_epi16(g, 4));
+        b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+
+        __m128i gb = _mm_or_si128(_mm_slli_epi16(g, 8), b);
+        __m128i ar = _mm_or_si128(alpha, r);
+
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_unpacklo_epi16(gb, ar));
+        _mm_storeu_si128((__m128i *)(dst + i + 4), _mm_unpackhi_epi16(gb, ar));
+    }
+
+    conv_scalar(dst + i, src + i, px_cnt - i);
+}
+#endif
+
+#if PIXEL_CONV_AVX2
+__attribute__((target("avx2")))
+static void conv_avx2(uint32_t *dst, const uint16_t *src, uint32_t px_cnt)
+{
+    const __m256i mask5 = _mm256_set1_epi16(0x1F);
+    const __m256i mask6 = _mm256_set1_epi16(0x3F);
+    const __m256i alpha = _mm256_set1_epi16((short)0xFF00);
+    uint32_t i = 0;
+
+    for(; i + 16 <= px_cnt; i += 16) {
+        __m256i c = _mm256_loadu_si256((const __m256i *)(src + i));
+
+        __m256i r = _mm256_and_si256(_mm256_srli_epi16(c, 11), mask5);
+        __m256i g = _mm256_and_si256(_mm256_srli_epi16(c, 5), mask6);
+        __m256i b = _mm256_and_si256(c, mask5);
+
+        r = _mm256_or_si256(_mm256_slli_epi16(r, 3), _mm256_srli_epi16(r, 2));
+        g = _mm256_or_si256(_mm256_slli_epi16(g, 2), _mm256_srli_epi16(g, 4));
+        b = _mm256_or_si256(_mm256_slli_epi16(b, 3), _mm256_srli_epi16(b, 2));
+
+        __m256i gb = _mm256_or_si256(_mm256_slli_epi16(g, 8), b);
+        __m256i ar = _mm256_or_si256(alpha, r);
+
+        // The unpacks work within the 128 bit lanes: pixels 0-3, 8-11 and 4-7, 12-15
+        __m256i lo = _mm256_unpacklo_epi16(gb, ar);
+        __m256i hi = _mm256_unpackhi_epi16(gb, ar);
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i *)(dst + i + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+
+    conv_scalar(dst + i, src + i, px_cnt - i);
+}
+#endif
+
+#if PIXEL_CONV_NEON
+static void conv_neon(uint32_t *dst, const uint16_t *src, uint32_t px_cnt)
+{
+    const uint16x8_t mask5 = vdupq_n_u16(0x1F);
+    const uint16x8_t mask6 = vdupq_n_u16(0x3F);
+    const uint16x8_t alpha = vdupq_n_u16(0xFF00);
+    uint32_t i = 0;
+
+    for(; i + 8 <= px_cnt; i += 8) {
+        uint16x8_t c = vld1q_u16(src + i);
+
+        uint16x8_t r = vshrq_n_u16(c, 11);
+        uint16x8_t g = vandq_u16(vshrq_n_u16(c, 5), mask6);
+        uint16x8_t b = vandq_u16(c, mask5);
+
+        r = vorrq_u16(vshlq_n_u16(r, 3), vshrq_n_u16(r, 2));
+        g = vorrq_u16(vshlq_n_u16(g, 2), vshrq_n_u16(g, 4));
+        b = vorrq_u16(vshlq_n_u16(b, 3), vshrq_n_u16(b, 2));
+
+        // The interleaving store writes gb0, ar0, gb1, ar1, ...
+        uint16x8x2_t out;
+        out.val[0] = vorrq_u16(vshlq_n_u16(g, 8), b);
+        out.val[1] = vorrq_u16(alpha, r);
+        vst2q_u16((uint16_t *)(dst + i), out);
+    }
+
+    conv_scalar(dst + i, src + i, px_cnt - i);
+}
+#endif
+
+#if PIXEL_CONV_MVE
+static void conv_mve(uint32_t *dst, const uint16_t *src, uint32_t px_cnt)
+{
+    uint32_t i = 0;
+
+    for(; i + 8 <= px_cnt; i += 8) {
+        uint16x8_t c = vld1q_u16(src + i);
+
+        uint16x8_t r = vshrq_n_u16(c, 11);
+        uint16x8_t g = vandq_u16(vshrq_n_u16(c, 5), vdupq_n_u16(0x3F));
+        uint16x8_t b = vandq_u16(c, vdupq_n_u16(0x1F));
+
+        r = vorrq_u16(vshlq_n_u16(r, 3), vshrq_n_u16(r, 2));
+        g = vorrq_u16(vshlq_n_u16(g, 2), vshrq_n_u16(g, 4));
+        b = vorrq_u16(vshlq_n_u16(b, 3), vshrq_n_u16(b, 2));
+
+        uint16x8x2_t out;
+        out.val[0] = vorrq_u16(vshlq_n_u16(g, 8), b);
+        out.val[1] = vorrq_u16(vdupq_n_u16(0xFF00), r);
+        vst2q_u16((uint16_t *)(dst + i), out);
+    }
+
+    conv_scalar(dst + i, src + i, px_cnt - i);
+}
+#endif
@@ -0,0 +1,63 @@
+/**
+ * @file pixel_conv.h
+ * RGB565 to ARGB8888 conversion of pixel rows
+ *
+ * The 5 and 6 bit channels are expanded by bit replication, so 0x1F becomes
+ * 0xFF (not 0xF8) and black and white stay exact. Vectorized kernels are
+ * compiled for the target (SSE2/AVX2 on x86, NEON on ARMv7/AArch64, Helium on
+ * Armv8.1-M) and the fastest one the CPU supports is picked at runtime.
+ * The output is 0xAARRGGBB words (SDL_PIXELFORMAT_ARGB8888) with alpha 0xFF.
+ */
+
+#ifndef PIXEL_CONV_H
+#define PIXEL_CONV_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef void (*pixel_conv_cb_t)(uint32_t *dst, const uint16_t *src, uint32_t px_cnt);
+
+typedef struct {
+    const char *name;
+    pixel_conv_cb_t cb;
+} pixel_conv_impl_t;
+
+/**
+ * Convert one pixel
+ * @param c         RGB565 color
+ * @return          0xFFRRGGBB
+ */
+static inline uint32_t pixel_conv_rgb565_px(uint16_t c)
+{
+    uint32_t r = (c >> 11) & 0x1F;
+    uint32_t g = (c >> 5) & 0x3F;
+    uint32_t b = c & 0x1F;
+
+    r = (r << 3) | (r >> 2);
+    g = (g << 2) | (g >> 4);
+    b = (b << 3) | (b >> 2);
+
+    return 0xFF000000u | (r << 16) | (g << 8) | b;
+}
+
+/**
+ * Convert a row of pixels with the selected kernel
+ * @param dst       destination, `px_cnt` words
+ * @param src       RGB565 source, `px_cnt` pixels (no alignment required)
+ * @param px_cnt    number of pixels
+ */
+void pixel_conv_rgb565_to_argb8888(uint32_t *dst, const uint16_t *src, uint32_t px_cnt);
+
+/**
+ * Get the kernels usable on this CPU, from the slowest (scalar) to the fastest
+ * @param cnt       store the number of kernels here
+ * @return          array of the kernels
+ */
+const pixel_conv_impl_t *pixel_conv_get_impls(uint32_t *cnt);
+
+/**
+ * Get the kernel used by `pixel_conv_rgb565_to_argb8888()`
+ */
+const pixel_conv_impl_t *pixel_conv_get_impl(void);
+
+#endif /*PIXEL_CONV_H*/
@@ -0,0 +1,218 @@
+/**
+ * @file render_tier.c
+ * Rendering quality/speed tiers of the text
+ */
+
+#include "render_tier.h"
+#include <string.h>
+
+typedef void (*draw_letter_cb_t)(lv_draw_ctx_t *, const lv_draw_label_dsc_t *, const lv_point_t *, uint32_t);
+
+static const char *const tier_names[_RENDER_TIER_CNT] = {
+    [RENDER_TIER_FULL] = "full",
+    [RENDER_TIER_FAST] = "fast",
+};
+
+static draw_letter_cb_t user_draw_letter;
+
+// Background of the container whose children are being drawn
+static bool bg_active;
+static lv_color_t bg_color;
+static lv_area_t bg_area;
+
+// Coverage to color for the last text color, background and bpp
+static lv_color_t lut[256];
+static lv_color_t lut_fg;
+static lv_color_t lut_bg;
+static uint32_t lut_bpp;
+
+static render_tier_stats_t stats;
+
+static void bg_event_cb(lv_event_t *e);
+static void fast_draw_letter(lv_draw_ctx_t *draw_ctx, const lv_draw_label_dsc_t *dsc, const lv_point_t *pos_p,
+                             uint32_t letter);
+static bool draw_on_bg(lv_draw_ctx_t *draw_ctx, const lv_draw_label_dsc_t *dsc, const lv_point_t *pos_p,
+                       uint32_t letter);
+static const lv_color_t *get_lut(lv_color_t fg, uint32_t bpp);
+
+bool render_tier_parse(const char *str, render_tier_t *tier)
+{
+    for(int i = 0; i < _RENDER_TIER_CNT; i++) {
+        if (strcmp(str, tier_names[i]) == 0) {
+            *tier = (render_tier_t)i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void render_tier_setup(lv_disp_t *disp, render_tier_t tier)
+{
+    lv_draw_ctx_t *draw_ctx = disp->driver->draw_ctx;
+
+    if (draw_ctx->draw_letter == fast_draw_letter) draw_ctx->draw_letter = user_draw_letter;
+
+    if (tier == RENDER_TIER_FAST) {
+        user_draw_letter = draw_ctx->draw_letter;
+        draw_ctx->draw_letter = fast_draw_letter;
+    }
+}
+
+void render_tier_watch_bg(lv_obj_t *cont)
+{
+    lv_obj_add_event_cb(cont, bg_event_cb, LV_EVENT_DRAW_MAIN_END, NULL);
+    lv_obj_add_event_cb(cont, bg_event_cb, LV_EVENT_DRAW_POST_BEGIN, NULL);
+}
+
+void render_tier_get_stats(render_tier_stats_t *s)
+{
+    *s = stats;
+}
+
+void render_tier_reset_stats(void)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+const char *render_tier_name(render_tier_t tier)
+{
+    if ((unsigned)tier >= _RENDER_TIER_CNT) return "unknown";
+
+    return tier_names[tier];
+}
+
+/**
+ * The children are drawn between the end of the container's main part and its post part
+ */
+static void bg_event_cb(lv_event_t *e)
+{
+    lv_obj_t *obj = lv_event_get_target(e);
+
+    if (lv_event_get_code(e) == LV_EVENT_DRAW_POST_BEGIN) {
+        bg_active = false;
+        return;
+    }
+
+    bg_active = lv_obj_get_style_bg_opa(obj, LV_PART_MAIN) >= LV_OPA_MAX &&
+                lv_obj_get_style_opa(obj, LV_PART_MAIN) >= LV_OPA_MAX &&
+                lv_obj_get_style_bg_grad_dir(obj, LV_PART_MAIN) == LV_GRAD_DIR_NONE &&
+                lv_obj_get_style_bg_img_src(obj, LV_PART_MAIN) == NULL &&
+                lv_obj_get_style_blend_mode(obj, LV_PART_MAIN) == LV_BLEND_MODE_NORMAL;
+    if (!bg_active) return;
+
+    bg_color = lv_obj_get_style_bg_color(obj, LV_PART_MAIN);
+    // Inside the border and the rounded corners
+    lv_coord_t inset = lv_obj_get_style_border_width(obj, LV_PART_MAIN) + lv_obj_get_style_radius(obj, LV_PART_MAIN);
+    lv_area_copy(&bg_area, &obj->coords);
+    lv_area_increase(&bg_area, (lv_coord_t)-inset, (lv_coord_t)-inset);
+}
+
+static void fast_draw_letter(lv_draw_ctx_t *draw_ctx, const lv_draw_label_dsc_t *dsc, const lv_point_t *pos_p,
+                             uint32_t letter)
+{
+    if (bg_active && draw_on_bg(draw_ctx, dsc, pos_p, letter)) {
+        stats.fast++;
+        return;
+    }
+
+    stats.blended++;
+    user_draw_letter(draw_ctx, dsc, pos_p, letter);
+}
+
+/**
+ * Write a glyph through the lookup table, as `lv_draw_sw_letter()` would blend it
+ * @return          false if the glyph has to be drawn by LVGL
+ */
+static bool draw_on_bg(lv_draw_ctx_t *draw_ctx, const lv_draw_label_dsc_t *dsc, const lv_point_t *pos_p,
+                       uint32_t letter)
+{
+    if (dsc->opa < LV_OPA_MAX || dsc->blend_mode != LV_BLEND_MODE_NORMAL) return false;
+
+    // Only the display's own buffer has the lv_color_t format: the layers of semi-transparent or
+    // transformed objects (and transparent screens) have an alpha byte per pixel
+    lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+    if (!disp || disp->driver->screen_transp || draw_ctx->buf != disp->driver->draw_buf->buf_act) return false;
+
+    // Missing glyphs get LVGL's placeholder
+    lv_font_glyph_dsc_t g;
+    if (!lv_font_get_glyph_dsc(dsc->font, &g, letter, '\0')) return false;
+    if (g.box_w == 0 || g.box_h == 0) return true;
+
+    uint32_t bpp = g.bpp;
+    if ((bpp != 1 && bpp != 2 && bpp != 4 && bpp != 8) || g.resolved_font->subpx) return false;
+
+    // Same position as in lv_draw_sw_letter()
+    lv_area_t box;
+    box.x1 = (lv_coord_t)(pos_p->x + g.ofs_x);
+    box.y1 = (lv_coord_t)(pos_p->y + (dsc->font->line_height - dsc->font->base_line) - g.box_h - g.ofs_y);
+    box.x2 = (lv_coord_t)(box.x1 + g.box_w - 1);
+    box.y2 = (lv_coord_t)(box.y1 + g.box_h - 1);
+    if (!_lv_area_is_in(&box, &bg_area, 0)) return false;
+
+    lv_area_t clip;
+    if (!_lv_area_intersect(&clip, &box, draw_ctx->clip_area)) return true;
+#if LV_DRAW_COMPLEX
+    if (lv_draw_mask_is_any(&clip)) return false;
+#endif
+
+    const uint8_t *map_p = lv_font_get_glyph_bitmap(g.resolved_font, letter);
+    if (!map_p) return false;
+
+    // The accelerators may still be filling the buffer
+    if (draw_ctx->wait_for_finish) draw_ctx->wait_for_finish(draw_ctx);
+
+    const lv_color_t *colors = get_lut(dsc->color, bpp);
+    uint32_t max = (1U << bpp) - 1;
+    lv_coord_t buf_w = lv_area_get_width(draw_ctx->buf_area);
+    lv_color_t *dst_row = (lv_color_t *)draw_ctx->buf + (int32_t)(clip.y1 - draw_ctx->buf_area->y1) * buf_w +
+                          (clip.x1 - draw_ctx->buf_area->x1);
+
+    uint32_t lut_px = 0;
+    uint32_t mixed_px = 0;
+    for(lv_coord_t y = clip.y1; y <= clip.y2; y++) {
+        // The rows of a glyph bitmap are not byte aligned
+        uint32_t bit = ((uint32_t)(y - box.y1) * g.box_w + (uint32_t)(clip.x1 - box.x1)) * bpp;
+        lv_color_t *dst = dst_row;
+
+        for(lv_coord_t x = clip.x1; x <= clip.x2; x++) {
+            uint32_t v = (map_p[bit >> 3] >> (8 - bpp - (bit & 7))) & max;
+            bit += bpp;
+
+            if (v == max || (v && dst->full == bg_color.full)) {
+                *dst = colors[v];
+                lut_px++;
+            } else if (v) {
+                // Overlaps the ink of another glyph: blend as LVGL does
+                *dst = lv_color_mix(dsc->color, *dst, (lv_opa_t)(v * 255 / max));
+                mixed_px++;
+            }
+            dst++;
+        }
+        dst_row += buf_w;
+    }
+    stats.lut_px += lut_px;
+    stats.mixed_px += mixed_px;
+
+    return true;
+}
+
+/**
+ * Colors of every coverage value on the background: the text color mixed with
+ * the opacity LVGL assigns to the value (v * 255 / max)
+ */
+static const lv_color_t *get_lut(lv_color_t fg, uint32_t bpp)
+{
+    if (lut_bpp == bpp && lut_fg.full == fg.full && lut_bg.full == bg_color.full) return lut;
+
+    uint32_t max = (1U << bpp) - 1;
+    for(uint32_t v = 0; v <= max; v++) {
+        lut[v] = v == max ? fg : lv_color_mix(fg, bg_color, (lv_opa_t)(v * 255 / max));
+    }
+    lut_bpp = bpp;
+    lut_fg = fg;
+    lut_bg = bg_color;
+    stats.lut_builds++;
+
+    return lut;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file render_tier.h
+ * Rendering quality/speed tiers of the text
+ *
+ * The screens are white and grey text on a solid black container, yet the
+ * software renderer turns every glyph into a mask and blends each covered
+ * pixel with read-modify-write arithmetic. In the fast tier the containers
+ * registered with `render_tier_watch_bg()` report their background color
+ * while their children are drawn, and the glyphs on it are written through
+ * a lookup table from coverage to color (16 entries with 4 bpp fonts)
+ * precomputed for the text and background colors. Pixels already inked by
+ * an overlapping glyph are still blended, so the result is the same as in the
+ * full tier. Anything else (masks, opacity, other blend modes, other
+ * backgrounds) falls back to LVGL's letter drawing.
+ *
+ * The reduced-bpp tier is a build option: the font subsets are generated with
+ * fewer shades by APP_FONT_BPP (see app_font.h), and the lookup table shrinks
+ * with them (4 entries with 2 bpp, 2 with 1 bpp).
+ */
+
+#ifndef RENDER_TIER_H
+#define RENDER_TIER_H
+
+#include "lvgl/lvgl.h"
+#include <stdbool.h>
+
+typedef enum {
+    RENDER_TIER_FULL,           /*LVGL's anti-aliased blending*/
+    RENDER_TIER_FAST,           /*Lookup table writes on solid backgrounds*/
+    _RENDER_TIER_CNT
+} render_tier_t;
+
+typedef struct {
+    uint32_t fast;              /*Glyphs written through the lookup table*/
+    uint32_t blended;           /*Glyphs drawn by LVGL*/
+    uint32_t lut_px;            /*Pixels of the fast glyphs written from the lookup table*/
+    uint32_t mixed_px;          /*Pixels of the fast glyphs blended over other ink*/
+    uint32_t lut_builds;        /*Lookup table recomputations (color changes)*/
+} render_tier_stats_t;
+
+/**
+ * Parse a tier given as "full" or "fast"
+ * @param str       the string to parse
+ * @param tier      the parsed tier
+ * @return          false if the string is not a valid tier
+ */
+bool render_tier_parse(const char *str, render_tier_t *tier);
+
+/**
+ * Apply a tier to the draw context of a display. Call it after
+ * `lv_disp_drv_register()` and again after `draw_backend_switch()`.
+ * @param disp      the display
+ * @param tier      the tier to use
+ */
+void render_tier_setup(lv_disp_t *disp, render_tier_t tier);
+
+/**
+ * Track the background of a container for the fast tier: it's used for the
+ * glyphs of its children while it's opaque and of a single color
+ * @param cont      the container (e.g. a screen)
+ */
+void render_tier_watch_bg(lv_obj_t *cont);
+
+/**
+ * Get the glyph and pixel counters since the start or the last reset
+ */
+void render_tier_get_stats(render_tier_stats_t *stats);
+
+void render_tier_reset_stats(void);
+
+/**
+ * Get the name of a tier (as accepted by `render_tier_parse()`)
+ */
+const char *render_tier_name(render_tier_t tier);
+
+#endif /*RENDER_TIER_H*/
@@ -0,0 +1,372 @@
+/**
+ * @file replay.c
+ * Headless deterministic replay of a trace recorded by the application
+ *
+ * The LVGL tick, the touch events and the wall clock come from the trace (see
+ * trace.h), so every run renders the same frames. Each `lv_timer_handler()`
+ * call of the recording is repeated and timed; after the calls which
+ * rendered, the RAM framebuffer is hashed (64 bit FNV-1a). The hash of all
+ * frames identifies the workload's output: builds which render differently
+ * print a different one, `--expect=` turns it into an exit code for
+ * `git bisect run`.
+ */
+
+#include "lvgl/lvgl.h"
+#include "app_conf.h"
+#include "app_theme.h"
+#include "app_tick.h"
+#include "draw_backend.h"
+#include "draw_buf.h"
+#include "flush_sched.h"
+#include "input_queue.h"
+#include "mem_display.h"
+#include "par_render.h"
+#include "render_tier.h"
+#include "timekeeper.h"
+#include "trace.h"
+#include "watch_ui.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#define FNV_OFFSET 0xCBF29CE484222325ULL
+#define FNV_PRIME  0x100000001B3ULL
+
+typedef struct {
+    uint32_t steps;
+    uint32_t frames;
+    uint32_t inputs;
+    uint32_t desyncs;                   // RTC reads which don't match the trace
+    uint64_t px;
+    uint64_t render_us_sum;
+    uint32_t *render_us;                // one sample per frame
+    uint32_t render_us_cap;
+    uint64_t hash;                      // hash of the frame hashes
+} replay_stats_t;
+
+static uint32_t sim_tick;
+static uint32_t frame_px;
+static bool frame_rendered;
+static int64_t last_time;
+static replay_stats_t stats;
+
+static uint32_t sim_tick_get(void);
+static int64_t trace_time_get(void);
+#if APP_FLUSH_SCHED
+static lv_coord_t sim_scan_line_get(void);
+#endif
+static void replay_monitor_cb(lv_disp_drv_t *drv, uint32_t time, uint32_t px);
+static void replay_touch_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data);
+static void replay_step(FILE *csv);
+static uint64_t fnv1a(uint64_t hash, const void *data, size_t size);
+static uint32_t percentile(uint32_t p);
+static int cmp_u32(const void *a, const void *b);
+
+int main(int argc, char **argv)
+{
+    draw_buf_mode_t buf_mode = APP_DRAW_BUF_MODE;
+    uint32_t buf_lines = APP_DRAW_BUF_LINES;
+    draw_backend_t backend = APP_DRAW_BACKEND;
+    bool minimal_theme = APP_THEME_MINIMAL;
+    render_tier_t tier = APP_RENDER_TIER;
+    const char *trace_path = NULL;
+    const char *csv_path = NULL;
+    const char *expect = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--buf=", 6) == 0 && draw_buf_parse(argv[i] + 6, &buf_mode, &buf_lines)) {
+            continue;
+        }
+        if (strncmp(argv[i], "--draw=", 7) == 0 && draw_backend_parse(argv[i] + 7, &backend)) {
+            continue;
+        }
+        if (strncmp(argv[i], "--theme=", 8) == 0 && app_theme_parse(argv[i] + 8, &minimal_theme)) {
+            continue;
+        }
+        if (strncmp(argv[i], "--render=", 9) == 0 && render_tier_parse(argv[i] + 9, &tier)) {
+            continue;
+        }
+        if (strncmp(argv[i], "--csv=", 6) == 0) {
+            csv_path = argv[i] + 6;
+            continue;
+        }
+        if (strncmp(argv[i], "--expect=", 9) == 0) {
+            expect = argv[i] + 9;
+            continue;
+        }
+        if (argv[i][0] != '-' && !trace_path) {
+            trace_path = argv[i];
+            continue;
+        }
+        trace_path = NULL;
+        break;
+    }
+    if (!trace_path) {
+        printf("Usage: %s <trace> [--buf=partial[:lines]|full|full-refresh|direct|direct-fb] [--draw=auto|sw|sw-bands|dma2d|arm2d|pxp] [--theme=default|minimal] [--render=full|fast] [--csv=file] [--expect=hash]\n", argv[0]);
+        return 1;
+    }
+
+    trace_header_t hdr;
+    if (!trace_open(trace_path, &hdr)) return 1;
+    if (hdr.hor_res != SCREEN_WIDTH || hdr.ver_res != SCREEN_HEIGHT) {
+        printf("The trace was recorded on %ux%u, this build is %ux%u\n", (unsigned)hdr.hor_res,
+               (unsigned)hdr.ver_res, (unsigned)SCREEN_WIDTH, (unsigned)SCREEN_HEIGHT);
+        trace_close();
+        return 1;
+    }
+
+    FILE *csv = NULL;
+    if (csv_path) {
+        csv = fopen(csv_path, "w");
+        if (!csv) {
+            printf("Can't open %s\n", csv_path);
+            trace_close();
+            return 1;
+        }
+        fprintf(csv, "frame,tick,render_us,px,hash\n");
+    }
+
+    // The recorded time is local time already
+    setenv("TZ", "UTC", 1);
+    tzset();
+
+    sim_tick = hdr.start_tick;
+    app_tick_set_source(sim_tick_get);
+    timekeeper_set_rtc(trace_time_get);
+
+    lv_init();
+
+    if (!mem_display_init(SCREEN_WIDTH, SCREEN_HEIGHT)) {
+        printf("Can't allocate the framebuffer\n");
+        return 1;
+    }
+
+    draw_buf_set_panel_fb(mem_display_get_fb());
+
+#if APP_PAR_RENDER
+    par_render_init(APP_PAR_RENDER_THREADS);
+#endif
+
+    static lv_disp_drv_t disp_drv;
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.flush_cb = mem_display_flush;
+    backend = draw_backend_setup(&disp_drv, backend);
+    disp_drv.hor_res = SCREEN_WIDTH;
+    disp_drv.ver_res = SCREEN_HEIGHT;
+    if (!draw_buf_setup(&disp_drv, buf_mode, buf_lines)) {
+        return 1;
+    }
+    disp_drv.monitor_cb = replay_monitor_cb;
+    lv_disp_t *disp = lv_disp_drv_register(&disp_drv);
+    app_theme_init(disp, minimal_theme);
+    render_tier_setup(disp, tier);
+#if APP_FLUSH_SCHED
+    flush_sched_attach(disp);
+    flush_sched_set_scan_line_cb(sim_scan_line_get);
+#endif
+
+    // Boot as the application did: the welcome frame is rendered unless the splash was shown
+    bool splash = (hdr.flags & TRACE_FLAG_SPLASH) != 0;
+    watch_ui_set_prerendered_splash(splash);
+    watch_ui_create();
+    stats.hash = FNV_OFFSET;
+    if (!splash) {
+        frame_rendered = false;
+        frame_px = 0;
+        lv_refr_now(disp);
+        if (frame_rendered) {
+            stats.hash = fnv1a(stats.hash, mem_display_get_fb(), (size_t)SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(lv_color_t));
+        }
+    }
+
+    static lv_indev_drv_t indev_drv;
+    lv_indev_drv_init(&indev_drv);
+    indev_drv.type = LV_INDEV_TYPE_POINTER;
+    indev_drv.read_cb = replay_touch_read;
+    lv_indev_t *indev = lv_indev_drv_register(&indev_drv);
+
+    trace_rec_t rec;
+    while (trace_read(&rec)) {
+        switch (rec.type) {
+        case TRACE_REC_STEP:
+            sim_tick = rec.tick;
+            replay_step(csv);
+            break;
+        case TRACE_REC_INPUT: {
+            input_event_t ev = { rec.x, rec.y, rec.pressed, app_tick_get_us() };
+            input_queue_push(&ev);
+            // As main.c does: read in the next step
+            lv_timer_resume(indev->driver->read_timer);
+            lv_timer_ready(indev->driver->read_timer);
+#if APP_AOD
+            watch_ui_wake();
+#endif
+            stats.inputs++;
+            break;
+        }
+        case TRACE_REC_TIME:
+            // Not consumed by the step it was recorded in
+            last_time = rec.time;
+            stats.desyncs++;
+            break;
+        }
+    }
+    trace_close();
+    if (csv) fclose(csv);
+
+    char hash_str[17];
+    snprintf(hash_str, sizeof(hash_str), "%016" PRIx64, stats.hash);
+
+    printf("Resolution: %dx%d, buffers: %s, backend: %s, theme: %s, render: %s\n", SCREEN_WIDTH, SCREEN_HEIGHT,
+           draw_buf_mode_name(buf_mode), draw_backend_name(backend), minimal_theme ? "minimal" : "default",
+           render_tier_name(tier));
+    printf("Steps: %u, frames: %u, inputs: %u, px: %llu, desyncs: %u\n", (unsigned)stats.steps,
+           (unsigned)stats.frames, (unsigned)stats.inputs, (unsigned long long)stats.px, (unsigned)stats.desyncs);
+    printf("Render: avg %.1f us, p50 %u us, p99 %u us, max %u us\n",
+           stats.frames ? (double)stats.render_us_sum / stats.frames : 0.0,
+           (unsigned)percentile(50), (unsigned)percentile(99), (unsigned)percentile(100));
+    printf("Hash: %s\n", hash_str);
+
+    free(stats.render_us);
+    mem_display_deinit();
+#if APP_PAR_RENDER
+    par_render_deinit();
+#endif
+
+    if (expect && strcmp(expect, hash_str) != 0) {
+        printf("Hash mismatch, expected %s\n", expect);
+        return 2;
+    }
+
+    return 0;
+}
+
+/**
+ * Tick of the trace
+ */
+static uint32_t sim_tick_get(void)
+{
+    return sim_tick;
+}
+
+/**
+ * RTC of the trace: the next time record, if the recording read the RTC here too
+ */
+static int64_t trace_time_get(void)
+{
+    trace_rec_t rec;
+    if (trace_peek(&rec) && rec.type == TRACE_REC_TIME) {
+        trace_read(&rec);
+        last_time = rec.time;
+    } else {
+        stats.desyncs++;
+    }
+
+    return last_time;
+}
+
+#if APP_FLUSH_SCHED
+/**
+ * Scan line of a simulated 60 Hz panel
+ */
+static lv_coord_t sim_scan_line_get(void)
+{
+    return (lv_coord_t)((sim_tick * 60 % 1000) * SCREEN_HEIGHT / 1000);
+}
+#endif
+
+/**
+ * Called by LVGL after every refresh
+ */
+static void replay_monitor_cb(lv_disp_drv_t *drv, uint32_t time, uint32_t px)
+{
+    LV_UNUSED(drv);
+    LV_UNUSED(time);
+
+    frame_rendered = true;
+    frame_px += px;
+}
+
+/**
+ * Read callback of main.c: pass the queued touch events
+ */
+static void replay_touch_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
+{
+    input_queue_read(indev_drv, data);
+
+#if APP_LOOP_MODE == APP_LOOP_WAIT
+    if (data->state == LV_INDEV_STATE_RELEASED && !data->continue_reading) {
+        lv_timer_pause(indev_drv->read_timer);
+    }
+#endif
+}
+
+/**
+ * Repeat one `lv_timer_handler()` call, hash the framebuffer if it rendered
+ */
+static void replay_step(FILE *csv)
+{
+    frame_rendered = false;
+    frame_px = 0;
+
+    uint64_t start = app_tick_get_us();
+    lv_timer_handler();
+    uint32_t elapsed = (uint32_t)(app_tick_get_us() - start);
+
+    stats.steps++;
+    if (!frame_rendered) return;
+
+    if (stats.frames == stats.render_us_cap) {
+        uint32_t cap = stats.render_us_cap ? stats.render_us_cap * 2 : 1024;
+        uint32_t *samples = realloc(stats.render_us, cap * sizeof(uint32_t));
+        if (samples) {
+            stats.render_us = samples;
+            stats.render_us_cap = cap;
+        }
+    }
+    if (stats.frames < stats.render_us_cap) stats.render_us[stats.frames] = elapsed;
+
+    uint64_t hash = fnv1a(FNV_OFFSET, mem_display_get_fb(), (size_t)SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(lv_color_t));
+    stats.hash = fnv1a(stats.hash, &hash, sizeof(hash));
+    stats.frames++;
+    stats.px += frame_px;
+    stats.render_us_sum += elapsed;
+
+    if (csv) {
+        fprintf(csv, "%u,%u,%u,%u,%016" PRIx64 "\n", (unsigned)stats.frames, (unsigned)sim_tick,
+                (unsigned)elapsed, (unsigned)frame_px, hash);
+    }
+}
+
+static uint64_t fnv1a(uint64_t hash, const void *data, size_t size)
+{
+    const uint8_t *p = data;
+    for(size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/**
+ * Render time percentile of the frames
+ * @param p     1..100
+ */
+static uint32_t percentile(uint32_t p)
+{
+    uint32_t cnt = stats.frames < stats.render_us_cap ? stats.frames : stats.render_us_cap;
+    if (cnt == 0) return 0;
+
+    qsort(stats.render_us, cnt, sizeof(uint32_t), cmp_u32);
+    return stats.render_us[(cnt * p + 99) / 100 - 1];
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return x < y ? -1 : x > y;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file screen_mgr.c
+ * On-demand construction and teardown of the screens
+ */
+
+#include "screen_mgr.h"
+#include "app_conf.h"
+#include "app_mem.h"
+
+static screen_mgr_screen_t *act_scr;
+
+static void build(screen_mgr_screen_t *scr);
+static void destroy(screen_mgr_screen_t *scr);
+static void prebuild_timer_cb(lv_timer_t *timer);
+
+void screen_mgr_show(screen_mgr_screen_t *scr)
+{
+    if (scr == act_scr) return;
+
+    if (!scr->cont) build(scr);
+    lv_obj_clear_flag(scr->cont, LV_OBJ_FLAG_HIDDEN);
+
+    screen_mgr_screen_t *prev = act_scr;
+    act_scr = scr;
+    if (!prev) return;
+
+    if (prev->persistent) {
+        lv_obj_add_flag(prev->cont, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        destroy(prev);
+    }
+}
+
+void screen_mgr_prebuild(screen_mgr_screen_t *scr, uint32_t delay)
+{
+    lv_timer_t *timer = lv_timer_create(prebuild_timer_cb, delay, scr);
+    lv_timer_set_repeat_count(timer, 1);
+}
+
+screen_mgr_screen_t *screen_mgr_get_act(void)
+{
+    return act_scr;
+}
+
+/**
+ * Create the container of a screen (hidden) and let the screen build its content
+ */
+static void build(screen_mgr_screen_t *scr)
+{
+#if APP_MEM_CUSTOM
+    // Persistent screens are never freed, so they don't need reusable blocks
+    if (scr->persistent) app_mem_arena_begin();
+#endif
+
+    scr->cont = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(scr->cont, lv_pct(100), lv_pct(100));
+    lv_obj_add_flag(scr->cont, LV_OBJ_FLAG_HIDDEN);
+    scr->create(scr->cont);
+
+#if APP_MEM_CUSTOM
+    if (scr->persistent) app_mem_arena_end();
+#endif
+}
+
+static void destroy(screen_mgr_screen_t *scr)
+{
+    if (scr->del) scr->del();
+    lv_obj_del(scr->cont);
+    scr->cont = NULL;
+}
+
+static void prebuild_timer_cb(lv_timer_t *timer)
+{
+    screen_mgr_screen_t *scr = timer->user_data;
+
+    if (!scr->cont) build(scr);
+}
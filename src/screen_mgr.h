@@ -0,0 +1,43 @@
+/**
+ * @file screen_mgr.h
+ * On-demand construction and teardown of the screens
+ *
+ * A screen is built into a full-size container on the active LVGL screen when
+ * it is first needed (or prebuilt, hidden, in a timer before its transition)
+ * and is deleted as soon as another screen replaces it, unless it's persistent.
+ */
+
+#ifndef SCREEN_MGR_H
+#define SCREEN_MGR_H
+
+#include "lvgl/lvgl.h"
+#include <stdbool.h>
+
+typedef struct {
+    const char *name;
+    void (*create)(lv_obj_t *cont);     /*Build the content into the screen's container*/
+    void (*del)(void);                  /*Release what is not a child of the container (timers etc.), can be NULL*/
+    bool persistent;                    /*Never deleted: kept when hidden and built from the app_mem arena*/
+    lv_obj_t *cont;                     /*The container while the screen exists, managed by screen_mgr*/
+} screen_mgr_screen_t;
+
+/**
+ * Show a screen, building it first if needed. The previously shown screen is
+ * hidden, and deleted unless it's persistent.
+ * @param scr       the screen (must stay valid while it exists)
+ */
+void screen_mgr_show(screen_mgr_screen_t *scr);
+
+/**
+ * Build a screen hidden after a delay, so the transition to it only has to show it
+ * @param scr       the screen
+ * @param delay     time to wait [ms], e.g. until the current screen is rendered
+ */
+void screen_mgr_prebuild(screen_mgr_screen_t *scr, uint32_t delay);
+
+/**
+ * Get the screen shown now (NULL if none)
+ */
+screen_mgr_screen_t *screen_mgr_get_act(void);
+
+#endif /*SCREEN_MGR_H*/
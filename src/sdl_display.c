@@ -0,0 +1,465 @@
+/**
+ * @file sdl_display.c
+ * SDL2 display backend of the simulator
+ *
+ * The content of the emulated panel lives in a texture which persists between
+ * frames, so LVGL only has to send the areas it has redrawn.
+ */
+
+#include "sdl_display.h"
+#include "app_conf.h"
+#include "draw_buf.h"
+#include "par_render.h"
+#include "pixel_conv.h"
+#include "telemetry.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if APP_FLUSH_ASYNC
+#include "flush_worker.h"
+#include <pthread.h>
+#endif
+
+#if LV_COLOR_DEPTH != 16 || LV_COLOR_16_SWAP != 0
+#error "The SDL display backend expects LV_COLOR_DEPTH 16 without LV_COLOR_16_SWAP"
+#endif
+
+#if APP_FLUSH_ASYNC && APP_SDL_FLUSH_MODE == APP_SDL_FLUSH_DRAW_POINT
+#error "APP_FLUSH_ASYNC can't be used with APP_SDL_FLUSH_DRAW_POINT (SDL rendering is not thread safe)"
+#endif
+
+#if APP_SDL_FLUSH_MODE == APP_SDL_FLUSH_TEXTURE && APP_SDL_TEXTURE_FORMAT == APP_SDL_TEXTURE_ARGB8888
+typedef struct {
+    const uint16_t *src;
+    int32_t src_stride;         /*[px]*/
+    void *dst;
+    int dst_pitch;              /*[bytes]*/
+    int32_t w;
+    int32_t h;
+} conv_job_t;
+#endif
+
+static SDL_Window *window = NULL;
+static SDL_Renderer *renderer = NULL;
+static SDL_Texture *texture = NULL;
+
+// Set by the flush callback, cleared when the texture is presented
+static bool frame_dirty = false;
+
+/* Copy of the panel memory. The transfer thread can't use the renderer, so it
+ * writes here and the main thread uploads the changed part before presenting.
+ * With `DRAW_BUF_DIRECT_FB` LVGL renders into it directly. */
+static lv_color_t *panel_fb = NULL;
+static int panel_w;
+static int panel_h;
+static lv_area_t panel_dirty;
+static bool panel_dirty_valid;
+
+#if APP_AOD
+// Idle mode of the emulated panel: the areas are reduced to 8 colours while copying
+static bool idle_mode;
+static lv_color_t *idle_buf;
+#endif
+
+#if APP_FLUSH_ASYNC
+static pthread_mutex_t panel_mutex = PTHREAD_MUTEX_INITIALIZER;
+static Uint32 frame_event_type;
+
+static void panel_write_area(const lv_area_t *area, const lv_color_t *src, int32_t src_stride);
+static void panel_frame_done(bool last);
+#endif
+static void panel_lock(void);
+static void panel_unlock(void);
+static void panel_add_dirty(const lv_area_t *area);
+static void copy_area(const lv_area_t *area, const lv_color_t *src, int32_t src_stride);
+#if APP_AOD
+static const lv_color_t *idle_convert(const lv_area_t *area, const lv_color_t *src, int32_t src_stride);
+#endif
+#if APP_SDL_FLUSH_MODE == APP_SDL_FLUSH_TEXTURE && APP_SDL_TEXTURE_FORMAT == APP_SDL_TEXTURE_ARGB8888
+static void conv_band(void *user_data, uint32_t idx, uint32_t cnt);
+#endif
+
+bool sdl_display_init(int hor_res, int ver_res, int zoom)
+{
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        printf("SDL_Init Error: %s\n", SDL_GetError());
+        return false;
+    }
+
+    window = SDL_CreateWindow("LVGL Watch Simulator",
+                              SDL_WINDOWPOS_CENTERED,
+                              SDL_WINDOWPOS_CENTERED,
+                              hor_res * zoom,
+                              ver_res * zoom,
+                              SDL_WINDOW_SHOWN);
+    if (!window) {
+        printf("SDL_CreateWindow Error: %s\n", SDL_GetError());
+        SDL_Quit();
+        return false;
+    }
+
+    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    if (!renderer) {
+        printf("SDL_CreateRenderer Error: %s\n", SDL_GetError());
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        return false;
+    }
+
+    panel_w = hor_res;
+    panel_h = ver_res;
+
+    // Enable logical size to match display resolution
+    SDL_RenderSetLogicalSize(renderer, hor_res, ver_res);
+
+#if APP_SDL_FLUSH_MODE == APP_SDL_FLUSH_DRAW_POINT
+    // The points are drawn into a target texture so that presenting works the same way
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGB565, SDL_TEXTUREACCESS_TARGET, hor_res, ver_res);
+#elif APP_SDL_TEXTURE_FORMAT == APP_SDL_TEXTURE_ARGB8888
+    // The rows are converted while copying (for renderers without RGB565 textures)
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, hor_res, ver_res);
+    printf("Pixel conversion: %s\n", pixel_conv_get_impl()->name);
+#else
+    // RGB565 matches lv_color_t, so the rows can be copied as they are
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGB565, SDL_TEXTUREACCESS_STREAMING, hor_res, ver_res);
+#endif
+    if (!texture) {
+        printf("SDL_CreateTexture Error: %s\n", SDL_GetError());
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        return false;
+    }
+
+#if APP_FLUSH_ASYNC
+    frame_event_type = SDL_RegisterEvents(1);
+    if (!sdl_display_get_fb() || !flush_worker_init(panel_write_area, panel_frame_done)) {
+        printf("Can't start the asynchronous flush\n");
+        free(panel_fb);
+        panel_fb = NULL;
+        SDL_DestroyTexture(texture);
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+void sdl_display_deinit(void)
+{
+#if APP_FLUSH_ASYNC
+    flush_worker_deinit();
+#endif
+    free(panel_fb);
+    panel_fb = NULL;
+    panel_dirty_valid = false;
+#if APP_AOD
+    free(idle_buf);
+    idle_buf = NULL;
+    idle_mode = false;
+#endif
+
+    SDL_DestroyTexture(texture);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+
+    texture = NULL;
+    renderer = NULL;
+    window = NULL;
+}
+
+void sdl_display_flush(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    lv_area_t areas[LV_INV_BUF_SIZE];
+    const lv_color_t *srcs[LV_INV_BUF_SIZE];
+    int32_t stride;
+    uint32_t cnt = draw_buf_get_flush_areas(disp_drv, area, color_p, areas, srcs, &stride);
+
+    if (color_p == panel_fb) {
+        // Rendered in place: only remember what to upload
+        panel_lock();
+        for(uint32_t i = 0; i < cnt; i++) {
+            panel_add_dirty(&areas[i]);
+        }
+        if (lv_disp_flush_is_last(disp_drv)) frame_dirty = true;
+        panel_unlock();
+
+        lv_disp_flush_ready(disp_drv);
+        return;
+    }
+
+#if APP_FLUSH_ASYNC
+    // Only hand the areas over, the thread signals flush ready when it's done
+    flush_worker_submit(disp_drv, areas, srcs, cnt, stride, lv_disp_flush_is_last(disp_drv));
+#else
+    for(uint32_t i = 0; i < cnt; i++) {
+        copy_area(&areas[i], srcs[i], stride);
+    }
+    frame_dirty = true;
+
+    lv_disp_flush_ready(disp_drv);
+#endif
+}
+
+bool sdl_display_present(void)
+{
+    // Upload what was written to the panel memory since the last present
+    panel_lock();
+    if (frame_dirty && panel_dirty_valid) {
+        copy_area(&panel_dirty, panel_fb + panel_dirty.y1 * panel_w + panel_dirty.x1, panel_w);
+        panel_dirty_valid = false;
+    }
+    // The texture keeps the previous frame, so there is nothing to show if LVGL didn't flush
+    bool dirty = frame_dirty;
+    frame_dirty = false;
+    panel_unlock();
+
+    if (!dirty) return false;
+
+    // The back buffer is undefined after a present, so it's cleared before copying the texture
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    SDL_RenderCopy(renderer, texture, NULL, NULL);
+    SDL_RenderPresent(renderer);
+
+    return true;
+}
+
+void sdl_display_invalidate(void)
+{
+    panel_lock();
+    frame_dirty = true;
+    panel_unlock();
+}
+
+lv_color_t *sdl_display_get_fb(void)
+{
+    if (!panel_fb) {
+        panel_fb = calloc((size_t)panel_w * panel_h, sizeof(lv_color_t));
+        if (!panel_fb) printf("Can't allocate the panel framebuffer\n");
+    }
+
+    return panel_fb;
+}
+
+void sdl_display_fb_changed(const lv_area_t *area)
+{
+    lv_area_t full = { 0, 0, (lv_coord_t)(panel_w - 1), (lv_coord_t)(panel_h - 1) };
+
+    panel_lock();
+    panel_add_dirty(area ? area : &full);
+    frame_dirty = true;
+    panel_unlock();
+}
+
+int sdl_display_get_refresh_hz(void)
+{
+    SDL_DisplayMode mode;
+    if (!window || SDL_GetWindowDisplayMode(window, &mode) != 0) return 0;
+
+    return mode.refresh_rate;
+}
+
+SDL_Renderer *sdl_display_get_renderer(void)
+{
+    return renderer;
+}
+
+#if APP_AOD
+void sdl_display_set_idle_mode(bool en)
+{
+    if (en == idle_mode) return;
+
+    if (en && !idle_buf) {
+        idle_buf = malloc((size_t)panel_w * panel_h * sizeof(lv_color_t));
+        if (!idle_buf) {
+            printf("Can't allocate the idle mode buffer\n");
+            return;
+        }
+    }
+    idle_mode = en;
+
+    // A panel only changes how it shows its memory, the texture has to be converted again
+    if (panel_fb) {
+        sdl_display_fb_changed(NULL);
+    } else {
+        lv_obj_invalidate(lv_scr_act());
+    }
+}
+#endif
+
+#if APP_FLUSH_ASYNC
+/**
+ * Write an area into the panel memory (called on the transfer thread)
+ */
+static void panel_write_area(const lv_area_t *area, const lv_color_t *src, int32_t src_stride)
+{
+    int32_t w = lv_area_get_width(area);
+    lv_color_t *dst = panel_fb + area->y1 * panel_w + area->x1;
+
+    panel_lock();
+    for(int32_t y = area->y1; y <= area->y2; y++) {
+        memcpy(dst, src, (size_t)w * sizeof(lv_color_t));
+        src += src_stride;
+        dst += panel_w;
+    }
+    panel_add_dirty(area);
+    panel_unlock();
+}
+
+/**
+ * Called on the transfer thread after each job; present once the whole refresh arrived
+ */
+static void panel_frame_done(bool last)
+{
+    if (!last) return;
+
+    panel_lock();
+    frame_dirty = true;
+    panel_unlock();
+
+    // Wake up the main loop if it's waiting for events
+    SDL_Event event;
+    SDL_memset(&event, 0, sizeof(event));
+    event.type = frame_event_type;
+    SDL_PushEvent(&event);
+}
+#endif /*APP_FLUSH_ASYNC*/
+
+/**
+ * The panel memory is shared with the transfer thread only with APP_FLUSH_ASYNC
+ */
+static void panel_lock(void)
+{
+#if APP_FLUSH_ASYNC
+    pthread_mutex_lock(&panel_mutex);
+#endif
+}
+
+static void panel_unlock(void)
+{
+#if APP_FLUSH_ASYNC
+    pthread_mutex_unlock(&panel_mutex);
+#endif
+}
+
+/**
+ * Add an area to the part of the panel memory to upload on the next present
+ */
+static void panel_add_dirty(const lv_area_t *area)
+{
+    if (panel_dirty_valid) {
+        _lv_area_join(&panel_dirty, &panel_dirty, area);
+    } else {
+        panel_dirty = *area;
+        panel_dirty_valid = true;
+    }
+}
+
+/**
+ * Copy an area into the panel texture
+ * @param area          area to update in screen coordinates
+ * @param src           first pixel of the area
+ * @param src_stride    width of the source buffer in pixels
+ */
+static void copy_area(const lv_area_t *area, const lv_color_t *src, int32_t src_stride)
+{
+    int32_t w = lv_area_get_width(area);
+    int32_t h = lv_area_get_height(area);
+
+    // This is the transfer to the emulated panel (always on the main thread)
+    telemetry_count_sent((uint32_t)(w * h));
+
+#if APP_AOD
+    if (idle_mode) {
+        src = idle_convert(area, src, src_stride);
+        src_stride = w;
+    }
+#endif
+
+#if APP_SDL_FLUSH_MODE == APP_SDL_FLUSH_DRAW_POINT
+    SDL_SetRenderTarget(renderer, texture);
+    for(int32_t y = 0; y < h; y++) {
+        for(int32_t x = 0; x < w; x++) {
+            uint32_t c = pixel_conv_rgb565_px(src[y * src_stride + x].full);
+            SDL_SetRenderDrawColor(renderer, (c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF, 0xFF);
+            SDL_RenderDrawPoint(renderer, area->x1 + x, area->y1 + y);
+        }
+    }
+    SDL_SetRenderTarget(renderer, NULL);
+#else
+    SDL_Rect rect = { area->x1, area->y1, w, h };
+#if APP_SDL_TEXTURE_FORMAT == APP_SDL_TEXTURE_ARGB8888
+    void *pixels;
+    int pitch;
+
+    if (SDL_LockTexture(texture, &rect, &pixels, &pitch) != 0) {
+        printf("SDL_LockTexture Error: %s\n", SDL_GetError());
+        return;
+    }
+
+    conv_job_t job = { (const uint16_t *)src, src_stride, pixels, pitch, w, h };
+#if APP_PAR_RENDER
+    // Large areas (e.g. a screen transition) are converted in bands on the render pool
+    uint32_t band_cnt = (uint32_t)h / APP_PAR_RENDER_MIN_ROWS;
+    if (band_cnt > par_render_get_thread_cnt()) band_cnt = par_render_get_thread_cnt();
+    if (w * h < APP_PAR_RENDER_MIN_PX) band_cnt = 1;
+    par_render_run(conv_band, &job, band_cnt ? band_cnt : 1);
+#else
+    conv_band(&job, 0, 1);
+#endif
+    SDL_UnlockTexture(texture);
+#else
+    // The renderer uploads straight from the source rows: the only copy on this path
+    if (SDL_UpdateTexture(texture, &rect, src, src_stride * (int)sizeof(lv_color_t)) != 0) {
+        printf("SDL_UpdateTexture Error: %s\n", SDL_GetError());
+    }
+#endif
+#endif
+}
+
+#if APP_SDL_FLUSH_MODE == APP_SDL_FLUSH_TEXTURE && APP_SDL_TEXTURE_FORMAT == APP_SDL_TEXTURE_ARGB8888
+/**
+ * Convert band `idx` of `cnt` of an area into the locked texture
+ */
+static void conv_band(void *user_data, uint32_t idx, uint32_t cnt)
+{
+    const conv_job_t *job = user_data;
+    int32_t y1 = job->h * (int32_t)idx / (int32_t)cnt;
+    int32_t y2 = job->h * (int32_t)(idx + 1) / (int32_t)cnt;
+
+    for(int32_t y = y1; y < y2; y++) {
+        pixel_conv_rgb565_to_argb8888((uint32_t *)((uint8_t *)job->dst + y * job->dst_pitch),
+                                      job->src + y * job->src_stride, (uint32_t)job->w);
+    }
+}
+#endif
+
+#if APP_AOD
+/**
+ * Keep the most significant bit of each channel, as a panel does in idle mode
+ * @return          the converted area in `idle_buf` with a stride of the area's width
+ */
+static const lv_color_t *idle_convert(const lv_area_t *area, const lv_color_t *src, int32_t src_stride)
+{
+    int32_t w = lv_area_get_width(area);
+    int32_t h = lv_area_get_height(area);
+    lv_color_t *dst = idle_buf;
+
+    for(int32_t y = 0; y < h; y++) {
+        for(int32_t x = 0; x < w; x++) {
+            uint16_t c = src[x].full;
+            dst[x].full = (uint16_t)((c & 0x8000 ? 0xF800 : 0) | (c & 0x0400 ? 0x07E0 : 0) | (c & 0x0010 ? 0x001F : 0));
+        }
+        src += src_stride;
+        dst += w;
+    }
+
+    return idle_buf;
+}
+#endif
@@ -0,0 +1,80 @@
+/**
+ * @file sdl_display.h
+ * SDL2 display backend of the simulator
+ */
+
+#ifndef SDL_DISPLAY_H
+#define SDL_DISPLAY_H
+
+#include "lvgl/lvgl.h"
+#include "app_conf.h"
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+/**
+ * Create the window, the renderer and the texture holding the panel content
+ * @param hor_res   horizontal resolution of the emulated panel
+ * @param ver_res   vertical resolution of the emulated panel
+ * @param zoom      window size multiplier
+ * @return          true on success (the SDL error is printed on failure)
+ */
+bool sdl_display_init(int hor_res, int ver_res, int zoom);
+
+/**
+ * Destroy everything created by `sdl_display_init()`
+ */
+void sdl_display_deinit(void);
+
+/**
+ * LVGL flush callback: copy the rendered area into the panel texture
+ */
+void sdl_display_flush(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p);
+
+/**
+ * Show the panel texture in the window if LVGL has flushed anything since the
+ * last call. Call it once after `lv_timer_handler()`.
+ * @return true if a new frame was presented
+ */
+bool sdl_display_present(void);
+
+/**
+ * Present the panel texture again on the next `sdl_display_present()` call
+ * even if LVGL didn't flush (e.g. the window was exposed)
+ */
+void sdl_display_invalidate(void);
+
+/**
+ * Get the memory of the emulated panel to render into with `DRAW_BUF_DIRECT_FB`
+ * (allocated on the first call). LVGL's redrawn areas are uploaded from it on present.
+ * @return          `hor_res * ver_res` pixels or NULL if it couldn't be allocated
+ */
+lv_color_t *sdl_display_get_fb(void);
+
+/**
+ * Upload an area of the panel memory on the next `sdl_display_present()` call
+ * after it was written without LVGL (e.g. the splash)
+ * @param area      the changed area or NULL for the whole panel
+ */
+void sdl_display_fb_changed(const lv_area_t *area);
+
+/**
+ * Get the refresh rate of the monitor showing the window
+ * @return          the rate [Hz] or 0 if unknown
+ */
+int sdl_display_get_refresh_hz(void);
+
+/**
+ * Get the renderer (e.g. to convert window coordinates to logical ones)
+ */
+SDL_Renderer *sdl_display_get_renderer(void);
+
+#if APP_AOD
+/**
+ * Emulate the 8 colour idle mode of the panel (see `watch_ui_set_aod_cb()`).
+ * As only the texture is kept, the next frame is sent in full.
+ * @param en        true to enter the idle mode
+ */
+void sdl_display_set_idle_mode(bool en);
+#endif
+
+#endif /*SDL_DISPLAY_H*/
@@ -0,0 +1,93 @@
+/**
+ * @file splash.c
+ * Pre-rendered splash screen stored as an RLE compressed RGB565 blob
+ */
+
+#include "splash.h"
+#include <string.h>
+
+#define MAX_REPEAT  (0x7F + 2)
+#define MAX_LITERAL 0x80
+
+static uint8_t *put_px(uint8_t *p, uint16_t c);
+
+size_t splash_encode(const uint16_t *px, uint16_t w, uint16_t h, uint8_t *out, size_t out_size)
+{
+    uint32_t px_cnt = (uint32_t)w * h;
+    uint8_t *p = out;
+    uint8_t *end = out + out_size;
+
+    if (out_size < SPLASH_HEADER_SIZE) return 0;
+    memcpy(p, "SPL1", 4);
+    p[4] = (uint8_t)w;
+    p[5] = (uint8_t)(w >> 8);
+    p[6] = (uint8_t)h;
+    p[7] = (uint8_t)(h >> 8);
+    p += SPLASH_HEADER_SIZE;
+
+    uint32_t i = 0;
+    while (i < px_cnt) {
+        uint32_t run = 1;
+        while (i + run < px_cnt && run < MAX_REPEAT && px[i + run] == px[i]) run++;
+
+        if (run >= 2) {
+            if (end - p < 3) return 0;
+            *p++ = (uint8_t)(0x80 | (run - 2));
+            p = put_px(p, px[i]);
+            i += run;
+            continue;
+        }
+
+        // Literals until the next run of two
+        uint32_t lit = 1;
+        while (i + lit < px_cnt && lit < MAX_LITERAL &&
+               (i + lit + 1 >= px_cnt || px[i + lit] != px[i + lit + 1])) {
+            lit++;
+        }
+        if ((size_t)(end - p) < 1 + lit * 2) return 0;
+        *p++ = (uint8_t)(lit - 1);
+        for(uint32_t k = 0; k < lit; k++) {
+            p = put_px(p, px[i + k]);
+        }
+        i += lit;
+    }
+
+    return (size_t)(p - out);
+}
+
+bool splash_decode(const uint8_t *blob, size_t size, uint16_t *dst, uint16_t w, uint16_t h)
+{
+    if (size < SPLASH_HEADER_SIZE || memcmp(blob, "SPL1", 4) != 0) return false;
+    if ((blob[4] | blob[5] << 8) != w || (blob[6] | blob[7] << 8) != h) return false;
+
+    const uint8_t *p = blob + SPLASH_HEADER_SIZE;
+    const uint8_t *end = blob + size;
+    uint16_t *d = dst;
+    uint16_t *d_end = dst + (uint32_t)w * h;
+
+    while (p < end && d < d_end) {
+        uint8_t c = *p++;
+
+        if (c & 0x80) {
+            uint32_t n = (uint32_t)(c & 0x7F) + 2;
+            if (end - p < 2 || (uint32_t)(d_end - d) < n) return false;
+            uint16_t color = (uint16_t)(p[0] | p[1] << 8);
+            p += 2;
+            for(uint32_t k = 0; k < n; k++) *d++ = color;
+        } else {
+            uint32_t n = (uint32_t)c + 1;
+            if ((uint32_t)(end - p) < n * 2 || (uint32_t)(d_end - d) < n) return false;
+            for(uint32_t k = 0; k < n; k++, p += 2) *d++ = (uint16_t)(p[0] | p[1] << 8);
+        }
+    }
+
+    return d == d_end;
+}
+
+static uint8_t *put_px(uint8_t *p, uint16_t c)
+{
+    p[0] = (uint8_t)c;
+    p[1] = (uint8_t)(c >> 8);
+
+    return p + 2;
+}
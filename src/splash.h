@@ -0,0 +1,53 @@
+/**
+ * @file splash.h
+ * Pre-rendered splash screen stored as an RLE compressed RGB565 blob
+ *
+ * tools/splash_gen renders the loading screen at build time and writes the
+ * blob as C source. At boot the blob is decoded straight into the panel
+ * framebuffer, before LVGL is even initialized.
+ *
+ * Format: "SPL1", width and height (16 bit little endian) and then records of
+ * a control byte `c` followed by RGB565 pixels (little endian):
+ * - `c & 0x80`: one pixel repeated `(c & 0x7F) + 2` times
+ * - otherwise `c + 1` literal pixels
+ */
+
+#ifndef SPLASH_H
+#define SPLASH_H
+
+#include "app_conf.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SPLASH_HEADER_SIZE 8
+
+#if APP_SPLASH
+/*Generated by tools/splash_gen*/
+extern const uint8_t splash_blob[];
+extern const uint32_t splash_blob_size;
+#endif
+
+/**
+ * Compress a frame
+ * @param px        RGB565 pixels, `w * h`
+ * @param w         width
+ * @param h         height
+ * @param out       destination of the blob
+ * @param out_size  size of `out`, `SPLASH_HEADER_SIZE + w * h * 2 + w * h / 128 + 1` is always enough
+ * @return          size of the blob, 0 if `out` is too small
+ */
+size_t splash_encode(const uint16_t *px, uint16_t w, uint16_t h, uint8_t *out, size_t out_size);
+
+/**
+ * Decompress a blob into a framebuffer
+ * @param blob      the blob (e.g. `splash_blob` or mapped from flash)
+ * @param size      size of the blob
+ * @param dst       framebuffer, `w * h` pixels
+ * @param w         width of the framebuffer
+ * @param h         height of the framebuffer
+ * @return          false if the blob is invalid or has a different size
+ */
+bool splash_decode(const uint8_t *blob, size_t size, uint16_t *dst, uint16_t w, uint16_t h);
+
+#endif /*SPLASH_H*/
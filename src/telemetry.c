@@ -0,0 +1,299 @@
+/**
+ * @file telemetry.c
+ * Frame time and render phase instrumentation
+ */
+
+#include "telemetry.h"
+
+#if APP_TELEMETRY
+
+#include "app_tick.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#if (APP_TELEMETRY_RING_SIZE & (APP_TELEMETRY_RING_SIZE - 1)) != 0
+#error "APP_TELEMETRY_RING_SIZE must be a power of 2"
+#endif
+
+#define OVERLAY_PERIOD 500  /*[ms]*/
+
+typedef void (*flush_cb_t)(lv_disp_drv_t *, const lv_area_t *, lv_color_t *);
+typedef void (*monitor_cb_t)(lv_disp_drv_t *, uint32_t, uint32_t);
+
+// Single producer (the LVGL thread) / single consumer ring buffer
+static telemetry_frame_t ring[APP_TELEMETRY_RING_SIZE];
+static atomic_uint ring_head;
+static atomic_uint ring_tail;
+static atomic_uint ring_dropped;
+
+// Wrapped callbacks of the display
+static flush_cb_t user_flush_cb;
+static monitor_cb_t user_monitor_cb;
+static lv_timer_cb_t user_refr_cb;
+
+// State of the refresh in progress (only used on the LVGL thread)
+static telemetry_frame_t cur;
+static bool cur_rendered;
+static uint64_t refr_us_in_handler;
+static uint64_t handler_us_acc;
+static uint32_t handler_cnt_acc;
+static telemetry_frame_t last_frame;
+
+// Power proxy since the last dump: what the panel receives and how often the CPU wakes up
+static uint64_t power_px;
+static uint32_t power_wakeups;
+static uint32_t power_start;
+
+static FILE *csv_file;
+static lv_obj_t *overlay_label;
+static lv_timer_t *overlay_timer;
+
+static void flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p);
+static void monitor_cb(lv_disp_drv_t *drv, uint32_t time, uint32_t px);
+static void refr_timer_cb(lv_timer_t *timer);
+static void dump_timer_cb(lv_timer_t *timer);
+static void overlay_timer_cb(lv_timer_t *timer);
+static void push(const telemetry_frame_t *frame);
+
+void telemetry_attach(lv_disp_t *disp)
+{
+    lv_disp_drv_t *drv = disp->driver;
+
+    user_flush_cb = drv->flush_cb;
+    drv->flush_cb = flush_cb;
+    user_monitor_cb = drv->monitor_cb;
+    drv->monitor_cb = monitor_cb;
+
+    // The refresh timer's callback renders and flushes the invalidated areas
+    user_refr_cb = disp->refr_timer->timer_cb;
+    lv_timer_set_cb(disp->refr_timer, refr_timer_cb);
+
+    power_start = lv_tick_get();
+
+#if APP_TELEMETRY_DUMP_PERIOD > 0
+    lv_timer_create(dump_timer_cb, APP_TELEMETRY_DUMP_PERIOD, NULL);
+#endif
+}
+
+uint32_t telemetry_timer_handler(void)
+{
+    refr_us_in_handler = 0;
+
+    uint64_t start = app_tick_get_us();
+    uint32_t idle_ms = lv_timer_handler();
+    uint64_t elapsed = app_tick_get_us() - start;
+
+    handler_us_acc += elapsed > refr_us_in_handler ? elapsed - refr_us_in_handler : 0;
+    handler_cnt_acc++;
+    // Each main loop iteration is one wakeup
+    power_wakeups++;
+
+    return idle_ms;
+}
+
+bool telemetry_pop(telemetry_frame_t *frame)
+{
+    unsigned tail = atomic_load_explicit(&ring_tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&ring_head, memory_order_acquire);
+    if (tail == head) return false;
+
+    *frame = ring[tail & (APP_TELEMETRY_RING_SIZE - 1)];
+    atomic_store_explicit(&ring_tail, tail + 1, memory_order_release);
+
+    return true;
+}
+
+uint32_t telemetry_get_dropped(void)
+{
+    return atomic_load_explicit(&ring_dropped, memory_order_relaxed);
+}
+
+bool telemetry_set_csv(const char *path)
+{
+    if (csv_file) {
+        fclose(csv_file);
+        csv_file = NULL;
+    }
+    if (!path) return true;
+
+    csv_file = fopen(path, "w");
+    if (!csv_file) {
+        printf("Can't open %s\n", path);
+        return false;
+    }
+    fprintf(csv_file, "tick,render_us,flush_us,flush_max_us,flush_cnt,px,handler_us,handler_cnt\n");
+
+    return true;
+}
+
+void telemetry_dump(void)
+{
+    telemetry_frame_t f;
+    uint32_t frames = 0;
+    uint64_t render_sum = 0, flush_sum = 0, px_sum = 0, handler_sum = 0;
+    uint32_t render_max = 0, flush_max = 0, flush_cnt = 0, handler_cnt = 0;
+
+    while (telemetry_pop(&f)) {
+        frames++;
+        render_sum += f.render_us;
+        flush_sum += f.flush_us;
+        px_sum += f.px;
+        handler_sum += f.handler_us;
+        flush_cnt += f.flush_cnt;
+        handler_cnt += f.handler_cnt;
+        if (f.render_us > render_max) render_max = f.render_us;
+        if (f.flush_max_us > flush_max) flush_max = f.flush_max_us;
+
+        if (csv_file) {
+            fprintf(csv_file, "%u,%u,%u,%u,%u,%u,%u,%u\n",
+                    (unsigned)f.tick, (unsigned)f.render_us, (unsigned)f.flush_us, (unsigned)f.flush_max_us,
+                    (unsigned)f.flush_cnt, (unsigned)f.px, (unsigned)f.handler_us, (unsigned)f.handler_cnt);
+        }
+    }
+    if (csv_file) fflush(csv_file);
+
+    // Also while nothing is rendered, e.g. between the minutes of the always-on display
+    telemetry_power_t power;
+    telemetry_get_power(&power);
+    printf("[telemetry] power: %llu px/h sent, %u wakeups/h\n",
+           (unsigned long long)power.px_per_hour, (unsigned)power.wakeups_per_hour);
+    power_px = 0;
+    power_wakeups = 0;
+    power_start = lv_tick_get();
+
+    if (frames == 0) return;
+
+    printf("[telemetry] %u frames: render avg %u us max %u us, flush avg %u us max %u us (%.1f/frame), "
+           "%u px/frame, handler %u us/call (%u calls), dropped %u\n",
+           (unsigned)frames,
+           (unsigned)(render_sum / frames), (unsigned)render_max,
+           (unsigned)(flush_sum / frames), (unsigned)flush_max, (double)flush_cnt / frames,
+           (unsigned)(px_sum / frames),
+           (unsigned)(handler_cnt ? handler_sum / handler_cnt : 0), (unsigned)handler_cnt,
+           (unsigned)telemetry_get_dropped());
+}
+
+void telemetry_count_sent(uint32_t px)
+{
+    power_px += px;
+}
+
+void telemetry_get_power(telemetry_power_t *power)
+{
+    uint32_t elapsed = lv_tick_elaps(power_start);
+    if (elapsed == 0) elapsed = 1;
+
+    power->px_per_hour = power_px * 3600000 / elapsed;
+    power->wakeups_per_hour = (uint32_t)((uint64_t)power_wakeups * 3600000 / elapsed);
+}
+
+void telemetry_set_overlay(bool en)
+{
+    if (en == (overlay_label != NULL)) return;
+
+    if (en) {
+        overlay_label = lv_label_create(lv_layer_top());
+        lv_obj_set_style_bg_color(overlay_label, lv_color_black(), 0);
+        lv_obj_set_style_bg_opa(overlay_label, LV_OPA_COVER, 0);
+        lv_obj_set_style_text_color(overlay_label, lv_color_make(0, 255, 0), 0);
+        lv_obj_set_style_text_font(overlay_label, &lv_font_montserrat_14, 0);
+        lv_obj_align(overlay_label, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+        lv_label_set_text(overlay_label, "");
+        overlay_timer = lv_timer_create(overlay_timer_cb, OVERLAY_PERIOD, NULL);
+        overlay_timer_cb(overlay_timer);
+    } else {
+        lv_timer_del(overlay_timer);
+        lv_obj_del(overlay_label);
+        overlay_timer = NULL;
+        overlay_label = NULL;
+    }
+}
+
+void telemetry_toggle_overlay(void)
+{
+    telemetry_set_overlay(overlay_label == NULL);
+}
+
+static void flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    uint64_t start = app_tick_get_us();
+    user_flush_cb(drv, area, color_p);
+    uint32_t elapsed = (uint32_t)(app_tick_get_us() - start);
+
+    cur.flush_us += elapsed;
+    cur.flush_cnt++;
+    if (elapsed > cur.flush_max_us) cur.flush_max_us = elapsed;
+}
+
+static void monitor_cb(lv_disp_drv_t *drv, uint32_t time, uint32_t px)
+{
+    cur_rendered = true;
+    cur.px += px;
+
+    if (user_monitor_cb) user_monitor_cb(drv, time, px);
+}
+
+static void refr_timer_cb(lv_timer_t *timer)
+{
+    telemetry_frame_t frame = { 0 };
+    cur = frame;
+    cur_rendered = false;
+
+    uint64_t start = app_tick_get_us();
+    user_refr_cb(timer);
+    uint32_t elapsed = (uint32_t)(app_tick_get_us() - start);
+
+    refr_us_in_handler += elapsed;
+
+    // LVGL calls monitor_cb only if something was rendered
+    if (!cur_rendered) return;
+
+    cur.render_us = elapsed > cur.flush_us ? elapsed - cur.flush_us : 0;
+    cur.tick = lv_tick_get();
+    cur.handler_us = (uint32_t)handler_us_acc;
+    cur.handler_cnt = handler_cnt_acc;
+    handler_us_acc = 0;
+    handler_cnt_acc = 0;
+
+    last_frame = cur;
+    push(&cur);
+}
+
+static void dump_timer_cb(lv_timer_t *timer)
+{
+    LV_UNUSED(timer);
+
+    telemetry_dump();
+}
+
+static void overlay_timer_cb(lv_timer_t *timer)
+{
+    LV_UNUSED(timer);
+    char buf[64];
+
+    lv_snprintf(buf, sizeof(buf), "R %u us\nF %u us x%u\n%u px",
+                (unsigned)last_frame.render_us, (unsigned)last_frame.flush_us,
+                (unsigned)last_frame.flush_cnt, (unsigned)last_frame.px);
+
+    // Setting the same text would trigger a refresh which the overlay would report again
+    if (strcmp(buf, lv_label_get_text(overlay_label)) != 0) {
+        lv_label_set_text(overlay_label, buf);
+    }
+}
+
+static void push(const telemetry_frame_t *frame)
+{
+    unsigned head = atomic_load_explicit(&ring_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&ring_tail, memory_order_acquire);
+
+    if (head - tail >= APP_TELEMETRY_RING_SIZE) {
+        atomic_fetch_add_explicit(&ring_dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    ring[head & (APP_TELEMETRY_RING_SIZE - 1)] = *frame;
+    atomic_store_explicit(&ring_head, head + 1, memory_order_release);
+}
+
+#endif /*APP_TELEMETRY*/
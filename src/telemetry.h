@@ -0,0 +1,115 @@
+/**
+ * @file telemetry.h
+ * Frame time and render phase instrumentation
+ *
+ * Every refresh of the display produces a `telemetry_frame_t` record which is
+ * stored in a lock-free single producer/single consumer ring buffer. The
+ * records can be read from any thread, dumped periodically to stdout and/or
+ * a CSV file, and summarized in an on-screen overlay.
+ * No SDL dependency, so the same code runs on the simulator and on the board.
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "lvgl/lvgl.h"
+#include "app_conf.h"
+#include <stdbool.h>
+
+typedef struct {
+    uint32_t tick;          /*LVGL tick at the end of the refresh [ms]*/
+    uint32_t render_us;     /*Time of the refresh excluding the flush callbacks*/
+    uint32_t flush_us;      /*Time spent in the flush callbacks*/
+    uint32_t flush_max_us;  /*Longest flush callback*/
+    uint32_t flush_cnt;     /*Number of flush callback calls*/
+    uint32_t px;            /*Refreshed pixels reported by LVGL*/
+    uint32_t handler_us;    /*Time in `lv_timer_handler()` outside of refreshes since the previous frame*/
+    uint32_t handler_cnt;   /*`lv_timer_handler()` calls since the previous frame*/
+} telemetry_frame_t;
+
+/*Power proxy: the panel transfer and the CPU wakeups dominate the consumption of the watch*/
+typedef struct {
+    uint64_t px_per_hour;       /*Pixels sent to the panel (see `telemetry_count_sent()`)*/
+    uint32_t wakeups_per_hour;  /*`telemetry_timer_handler()` calls, one per main loop wakeup*/
+} telemetry_power_t;
+
+#if APP_TELEMETRY
+
+/**
+ * Start collecting frame records of a display: wraps its flush, monitor and
+ * refresh timer callbacks. Call it after `lv_disp_drv_register()`.
+ * @param disp      display to instrument
+ */
+void telemetry_attach(lv_disp_t *disp);
+
+/**
+ * Call it instead of `lv_timer_handler()` to measure the handler overhead
+ * @return          the return value of `lv_timer_handler()`
+ */
+uint32_t telemetry_timer_handler(void);
+
+/**
+ * Pop the oldest frame record (can be called from any single consumer thread)
+ * @param frame     store the record here
+ * @return          false if the ring buffer is empty
+ */
+bool telemetry_pop(telemetry_frame_t *frame);
+
+/**
+ * Get the number of records dropped because the ring buffer was full
+ */
+uint32_t telemetry_get_dropped(void);
+
+/**
+ * Write every record to a CSV file on each dump (in addition to the summary)
+ * @param path      path of the file, NULL to stop writing
+ * @return          false if the file couldn't be opened
+ */
+bool telemetry_set_csv(const char *path);
+
+/**
+ * Pop all the records and print a summary to stdout (also done every
+ * `APP_TELEMETRY_DUMP_PERIOD` ms by an LVGL timer)
+ */
+void telemetry_dump(void);
+
+/**
+ * Count pixels sent to the panel. Called by the display driver where the pixels
+ * leave for the panel, which is not always what LVGL rendered (e.g. merged dirty areas
+ * of a framebuffer or a full upload after the panel's color mode changed).
+ * Call it on the LVGL thread.
+ * @param px        number of pixels sent
+ */
+void telemetry_count_sent(uint32_t px);
+
+/**
+ * Get the power proxy rates since the last dump (extrapolated to an hour)
+ * @param power     store the rates here
+ */
+void telemetry_get_power(telemetry_power_t *power);
+
+/**
+ * Show or hide the overlay with the latest frame statistics on the top layer
+ */
+void telemetry_set_overlay(bool en);
+
+/**
+ * Toggle the overlay
+ */
+void telemetry_toggle_overlay(void);
+
+#else
+
+static inline uint32_t telemetry_timer_handler(void)
+{
+    return lv_timer_handler();
+}
+
+static inline void telemetry_count_sent(uint32_t px)
+{
+    (void)px;
+}
+
+#endif /*APP_TELEMETRY*/
+
+#endif /*TELEMETRY_H*/
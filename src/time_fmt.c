@@ -0,0 +1,116 @@
+/**
+ * @file time_fmt.c
+ * Allocation free time conversion and formatting for the watch face
+ */
+
+#include "time_fmt.h"
+
+static const char wday_names[7][4] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+static const char month_names[12][4] = {
+    "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+};
+
+static int32_t days_from_civil(int32_t y, uint32_t m, uint32_t d);
+static char *put_2digits(char *p, uint32_t v);
+static char *put_name(char *p, const char *name);
+
+void time_fmt_split(time_t t, int32_t utc_offset, time_fmt_tm_t *tm)
+{
+    int64_t local = (int64_t)t + utc_offset;
+    int64_t days = local / 86400;
+    int64_t secs = local % 86400;
+    if (secs < 0) {
+        secs += 86400;
+        days--;
+    }
+
+    tm->days = (int32_t)days;
+    tm->hour = (uint8_t)(secs / 3600);
+    tm->min = (uint8_t)(secs / 60 % 60);
+    tm->sec = (uint8_t)(secs % 60);
+    // 1970-01-01 was a Thursday
+    tm->wday = (uint8_t)((days % 7 + 11) % 7);
+
+    // civil_from_days() of H. Hinnant's date algorithms: eras of 400 years starting on March 1
+    int64_t z = days + 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    uint32_t doe = (uint32_t)(z - era * 146097);
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    uint32_t mp = (5 * doy + 2) / 153;
+
+    tm->mday = (uint8_t)(doy - (153 * mp + 2) / 5 + 1);
+    tm->month = (uint8_t)(mp < 10 ? mp + 3 : mp - 9);
+    tm->year = (int32_t)(yoe + era * 400) + (tm->month <= 2);
+}
+
+int32_t time_fmt_get_utc_offset(time_t t)
+{
+    struct tm *lt = localtime(&t);
+    if (!lt) return 0;
+
+    int64_t local = (int64_t)days_from_civil(lt->tm_year + 1900, (uint32_t)lt->tm_mon + 1, (uint32_t)lt->tm_mday) * 86400 +
+                    lt->tm_hour * 3600 + lt->tm_min * 60 + lt->tm_sec;
+
+    return (int32_t)(local - (int64_t)t);
+}
+
+void time_fmt_hms(char *buf, const time_fmt_tm_t *tm)
+{
+    char *p = buf;
+
+    p = put_2digits(p, tm->hour);
+    *p++ = ':';
+    p = put_2digits(p, tm->min);
+    *p++ = ':';
+    p = put_2digits(p, tm->sec);
+    *p = '\0';
+}
+
+void time_fmt_date(char *buf, const time_fmt_tm_t *tm)
+{
+    char *p = buf;
+    uint32_t year = (uint32_t)tm->year % 10000;
+
+    p = put_name(p, wday_names[tm->wday]);
+    *p++ = ',';
+    *p++ = ' ';
+    p = put_name(p, month_names[tm->month - 1]);
+    *p++ = ' ';
+    p = put_2digits(p, tm->mday);
+    *p++ = ' ';
+    p = put_2digits(p, year / 100);
+    p = put_2digits(p, year % 100);
+    *p = '\0';
+}
+
+/**
+ * Days since 1970-01-01 of a date (days_from_civil() of H. Hinnant's date algorithms)
+ */
+static int32_t days_from_civil(int32_t y, uint32_t m, uint32_t d)
+{
+    y -= m <= 2;
+    int32_t era = (y >= 0 ? y : y - 399) / 400;
+    uint32_t yoe = (uint32_t)(y - era * 400);
+    uint32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + (int32_t)doe - 719468;
+}
+
+static char *put_2digits(char *p, uint32_t v)
+{
+    p[0] = (char)('0' + v / 10);
+    p[1] = (char)('0' + v % 10);
+
+    return p + 2;
+}
+
+static char *put_name(char *p, const char *name)
+{
+    p[0] = name[0];
+    p[1] = name[1];
+    p[2] = name[2];
+
+    return p + 3;
+}
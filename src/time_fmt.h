@@ -0,0 +1,64 @@
+/**
+ * @file time_fmt.h
+ * Allocation free time conversion and formatting for the watch face
+ *
+ * Replaces `localtime()` + `strftime()` on the clock tick: the calendar fields
+ * are computed arithmetically from the time and a cached UTC offset, and the
+ * text is written in place into caller-owned buffers (C locale names only).
+ */
+
+#ifndef TIME_FMT_H
+#define TIME_FMT_H
+
+#include <stdint.h>
+#include <time.h>
+
+/*"HH:MM:SS" plus the terminating zero*/
+#define TIME_FMT_HMS_LEN  9
+/*"Www, Mmm DD YYYY" plus the terminating zero*/
+#define TIME_FMT_DATE_LEN 17
+/*Every character `time_fmt_date()` can write (with duplicates)*/
+#define TIME_FMT_DATE_CHARS "0123456789, SunMonTueWedThuFriSatJanFebMarAprMayJunJulAugSepOctNovDec"
+
+typedef struct {
+    int32_t year;
+    uint8_t month;      /*1..12*/
+    uint8_t mday;       /*1..31*/
+    uint8_t wday;       /*0..6, 0: Sunday*/
+    uint8_t hour;
+    uint8_t min;
+    uint8_t sec;
+    int32_t days;       /*Days since 1970-01-01, changes exactly when the date does*/
+} time_fmt_tm_t;
+
+/**
+ * Split a time into calendar fields
+ * @param t             seconds since the epoch
+ * @param utc_offset    offset of the local time from UTC [s]
+ * @param tm            store the fields here
+ */
+void time_fmt_split(time_t t, int32_t utc_offset, time_fmt_tm_t *tm);
+
+/**
+ * Get the offset of the local time zone from UTC at a given time with
+ * `localtime()`. It changes only on DST transitions, so cache it.
+ * @param t             seconds since the epoch
+ * @return              the offset [s]
+ */
+int32_t time_fmt_get_utc_offset(time_t t);
+
+/**
+ * Write "HH:MM:SS"
+ * @param buf           at least `TIME_FMT_HMS_LEN` bytes
+ * @param tm            the time
+ */
+void time_fmt_hms(char *buf, const time_fmt_tm_t *tm);
+
+/**
+ * Write "Www, Mmm DD YYYY" (as `strftime()` "%a, %b %d %Y" in the C locale)
+ * @param buf           at least `TIME_FMT_DATE_LEN` bytes
+ * @param tm            the date (years 0..9999)
+ */
+void time_fmt_date(char *buf, const time_fmt_tm_t *tm);
+
+#endif /*TIME_FMT_H*/
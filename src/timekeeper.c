@@ -0,0 +1,114 @@
+/**
+ * @file timekeeper.c
+ * Wall clock of the watch face: one RTC read, then the LVGL tick
+ */
+
+#include "timekeeper.h"
+#include "lvgl/lvgl.h"
+#include <time.h>
+
+#if 60 % APP_TIMEKEEPER_SYNC_MIN != 0
+#error "APP_TIMEKEEPER_SYNC_MIN must divide 60"
+#endif
+
+static timekeeper_rtc_cb_t rtc_cb = timekeeper_system_time;
+static bool synced = false;
+static int64_t anchor_ms;           /*UTC time of the last RTC read*/
+static uint32_t anchor_tick;        /*LVGL tick at the last RTC read*/
+static int32_t utc_offset;          /*Local time - UTC [s]*/
+static int64_t cur_sec = -1;        /*Local time of the cached fields [s]*/
+static time_fmt_tm_t cur_tm;
+
+static void sync(void);
+static int64_t local_ms(void);
+static uint32_t diff_fields(const time_fmt_tm_t *a, const time_fmt_tm_t *b);
+
+void timekeeper_set_rtc(timekeeper_rtc_cb_t cb)
+{
+    rtc_cb = cb ? cb : timekeeper_system_time;
+    synced = false;
+}
+
+void timekeeper_invalidate(void)
+{
+    synced = false;
+}
+
+uint32_t timekeeper_update(time_fmt_tm_t *tm)
+{
+    uint32_t changed = 0;
+
+    if (!synced) sync();
+
+    int64_t sec = local_ms() / 1000;
+    if (sec / 60 != cur_sec / 60 && (sec / 60) % APP_TIMEKEEPER_SYNC_MIN == 0) {
+        // Periodic RTC read: corrects the drift of the tick and follows DST changes
+        sync();
+        sec = local_ms() / 1000;
+    }
+
+    if (sec != cur_sec) {
+        time_fmt_tm_t prev = cur_tm;
+
+        if (cur_sec >= 0 && sec / 60 == cur_sec / 60) {
+            // Same minute: only the seconds change
+            cur_tm.sec = (uint8_t)(sec % 60);
+        } else {
+            time_fmt_split((time_t)(sec - utc_offset), utc_offset, &cur_tm);
+        }
+
+        changed = cur_sec < 0 ? TIMEKEEPER_CHANGED_ALL : diff_fields(&prev, &cur_tm);
+        cur_sec = sec;
+    }
+
+    *tm = cur_tm;
+    return changed;
+}
+
+uint32_t timekeeper_ms_to_next(uint32_t period_s)
+{
+    if (!synced) sync();
+
+    int64_t period_ms = (int64_t)period_s * 1000;
+    return (uint32_t)(period_ms - local_ms() % period_ms);
+}
+
+int64_t timekeeper_system_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * Read the RTC and the UTC offset, and anchor the time to the tick
+ */
+static void sync(void)
+{
+    anchor_ms = rtc_cb();
+    anchor_tick = lv_tick_get();
+    utc_offset = time_fmt_get_utc_offset((time_t)(anchor_ms / 1000));
+    synced = true;
+}
+
+/**
+ * Local time [ms], never negative (clamped to 1970-01-01)
+ */
+static int64_t local_ms(void)
+{
+    int64_t t = anchor_ms + lv_tick_elaps(anchor_tick) + (int64_t)utc_offset * 1000;
+    return t > 0 ? t : 0;
+}
+
+static uint32_t diff_fields(const time_fmt_tm_t *a, const time_fmt_tm_t *b)
+{
+    uint32_t changed = 0;
+
+    if (a->sec != b->sec) changed |= TIMEKEEPER_CHANGED_SEC;
+    if (a->min != b->min) changed |= TIMEKEEPER_CHANGED_MIN;
+    if (a->hour != b->hour) changed |= TIMEKEEPER_CHANGED_HOUR;
+    if (a->days != b->days) changed |= TIMEKEEPER_CHANGED_DAY;
+
+    return changed;
+}
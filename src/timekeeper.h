@@ -0,0 +1,64 @@
+/**
+ * @file timekeeper.h
+ * Wall clock of the watch face: one RTC read, then the LVGL tick
+ *
+ * The RTC is read when the clock starts and again every
+ * `APP_TIMEKEEPER_SYNC_MIN` minutes; in between the time is the last reading
+ * plus the elapsed tick (app_tick.h), which is monotonic and cheap. The
+ * calendar fields are cached: within a minute an update only changes the
+ * seconds, the other fields are recomputed (arithmetically, see time_fmt.h)
+ * on minute rollovers, the UTC offset only when the RTC is read.
+ * As the reading has millisecond resolution, the time to the next second
+ * edge is known, so the clock timer can fire right after it instead of
+ * drifting against it (which shows a second twice or skips one).
+ */
+
+#ifndef TIMEKEEPER_H
+#define TIMEKEEPER_H
+
+#include "app_conf.h"
+#include "time_fmt.h"
+#include <stdint.h>
+
+/*Fields changed by an update*/
+#define TIMEKEEPER_CHANGED_SEC  0x01
+#define TIMEKEEPER_CHANGED_MIN  0x02
+#define TIMEKEEPER_CHANGED_HOUR 0x04
+#define TIMEKEEPER_CHANGED_DAY  0x08
+#define TIMEKEEPER_CHANGED_ALL  0x0F
+
+/*Callback reading the RTC: UTC milliseconds since 1970-01-01*/
+typedef int64_t (*timekeeper_rtc_cb_t)(void);
+
+/**
+ * Replace the RTC (e.g. with a simulated clock) and read it on the next update.
+ * Pass NULL to restore `timekeeper_system_time()`.
+ */
+void timekeeper_set_rtc(timekeeper_rtc_cb_t cb);
+
+/**
+ * Read the RTC on the next update (e.g. after the time was set)
+ */
+void timekeeper_invalidate(void);
+
+/**
+ * Bring the cached calendar fields to the current second
+ * @param tm        store the local time here
+ * @return          TIMEKEEPER_CHANGED_... bits of the fields which changed since
+ *                  the previous update (all of them on the first one)
+ */
+uint32_t timekeeper_update(time_fmt_tm_t *tm);
+
+/**
+ * Get the time until the local time reaches the next multiple of a period
+ * @param period_s  e.g. 1 for the next second, 60 for the next minute
+ * @return          1..period_s * 1000 [ms]
+ */
+uint32_t timekeeper_ms_to_next(uint32_t period_s);
+
+/**
+ * Default RTC: `clock_gettime(CLOCK_REALTIME)`
+ */
+int64_t timekeeper_system_time(void);
+
+#endif /*TIMEKEEPER_H*/
@@ -0,0 +1,249 @@
+/**
+ * @file trace.c
+ * Capture of the render loop's inputs into a compact binary trace
+ */
+
+#include "trace.h"
+#include "time_fmt.h"
+#include "timekeeper.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TRACE_MAGIC     "WRPL"
+#define TRACE_HDR_SIZE  14
+#define TRACE_TAG_MASK  0x7F
+#define TRACE_PRESSED   0x80
+
+static FILE *capture_file;
+static uint32_t capture_tick;
+static int64_t capture_time;
+static uint32_t capture_rec_cnt;
+
+static FILE *read_file;
+static uint32_t read_tick;
+static int64_t read_time;
+static trace_rec_t peeked;
+static bool peeked_valid;
+
+static void put_varint(uint64_t v);
+static void put_svarint(int64_t v);
+static bool get_varint(uint64_t *v);
+static bool get_svarint(int64_t *v);
+static bool read_rec(trace_rec_t *rec);
+
+bool trace_capture_start(const char *path, const trace_header_t *hdr)
+{
+    capture_file = fopen(path, "wb");
+    if (!capture_file) {
+        printf("Can't open %s\n", path);
+        return false;
+    }
+
+    uint8_t buf[TRACE_HDR_SIZE];
+    memcpy(buf, TRACE_MAGIC, 4);
+    buf[4] = TRACE_VERSION;
+    buf[5] = (uint8_t)hdr->hor_res;
+    buf[6] = (uint8_t)(hdr->hor_res >> 8);
+    buf[7] = (uint8_t)hdr->ver_res;
+    buf[8] = (uint8_t)(hdr->ver_res >> 8);
+    for(int i = 0; i < 4; i++) {
+        buf[9 + i] = (uint8_t)(hdr->start_tick >> (8 * i));
+    }
+    buf[13] = hdr->flags;
+    fwrite(buf, 1, sizeof(buf), capture_file);
+
+    capture_tick = hdr->start_tick;
+    capture_time = 0;
+    capture_rec_cnt = 0;
+
+    return true;
+}
+
+void trace_capture_stop(void)
+{
+    if (!capture_file) return;
+
+    long size = ftell(capture_file);
+    fclose(capture_file);
+    capture_file = NULL;
+
+    printf("[trace] %u records, %ld bytes\n", (unsigned)capture_rec_cnt, size);
+}
+
+void trace_capture_step(uint32_t tick)
+{
+    if (!capture_file) return;
+
+    fputc(TRACE_REC_STEP, capture_file);
+    put_varint(tick - capture_tick);
+    capture_tick = tick;
+    capture_rec_cnt++;
+}
+
+void trace_capture_input(lv_coord_t x, lv_coord_t y, bool pressed)
+{
+    if (!capture_file) return;
+
+    fputc(TRACE_REC_INPUT | (pressed ? TRACE_PRESSED : 0), capture_file);
+    put_svarint(x);
+    put_svarint(y);
+    capture_rec_cnt++;
+}
+
+int64_t trace_capture_time(void)
+{
+    int64_t now = timekeeper_system_time();
+    if (!capture_file) return now;
+
+    // Replayed in UTC: store what the clock shows here
+    int64_t local = now + (int64_t)time_fmt_get_utc_offset((time_t)(now / 1000)) * 1000;
+    fputc(TRACE_REC_TIME, capture_file);
+    put_svarint(local - capture_time);
+    capture_time = local;
+    capture_rec_cnt++;
+
+    return now;
+}
+
+bool trace_open(const char *path, trace_header_t *hdr)
+{
+    read_file = fopen(path, "rb");
+    if (!read_file) {
+        printf("Can't open %s\n", path);
+        return false;
+    }
+
+    uint8_t buf[TRACE_HDR_SIZE];
+    if (fread(buf, 1, sizeof(buf), read_file) != sizeof(buf) || memcmp(buf, TRACE_MAGIC, 4) != 0) {
+        printf("%s is not a trace\n", path);
+        trace_close();
+        return false;
+    }
+    if (buf[4] != TRACE_VERSION) {
+        printf("%s: unsupported trace version %u\n", path, (unsigned)buf[4]);
+        trace_close();
+        return false;
+    }
+
+    hdr->hor_res = (uint16_t)(buf[5] | (buf[6] << 8));
+    hdr->ver_res = (uint16_t)(buf[7] | (buf[8] << 8));
+    hdr->start_tick = 0;
+    for(int i = 0; i < 4; i++) {
+        hdr->start_tick |= (uint32_t)buf[9 + i] << (8 * i);
+    }
+    hdr->flags = buf[13];
+
+    read_tick = hdr->start_tick;
+    read_time = 0;
+    peeked_valid = false;
+
+    return true;
+}
+
+bool trace_read(trace_rec_t *rec)
+{
+    if (peeked_valid) {
+        *rec = peeked;
+        peeked_valid = false;
+        return true;
+    }
+
+    return read_rec(rec);
+}
+
+bool trace_peek(trace_rec_t *rec)
+{
+    if (!peeked_valid) {
+        if (!read_rec(&peeked)) return false;
+        peeked_valid = true;
+    }
+
+    *rec = peeked;
+    return true;
+}
+
+void trace_close(void)
+{
+    if (read_file) fclose(read_file);
+    read_file = NULL;
+    peeked_valid = false;
+}
+
+/**
+ * Decode the next record from the file, the deltas are resolved to absolute values
+ */
+static bool read_rec(trace_rec_t *rec)
+{
+    if (!read_file) return false;
+
+    int tag = fgetc(read_file);
+    if (tag == EOF) return false;
+
+    memset(rec, 0, sizeof(*rec));
+    rec->type = (trace_rec_type_t)(tag & TRACE_TAG_MASK);
+
+    uint64_t delta;
+    int64_t sdelta, x, y;
+    switch (rec->type) {
+    case TRACE_REC_STEP:
+        if (!get_varint(&delta)) return false;
+        read_tick += (uint32_t)delta;
+        rec->tick = read_tick;
+        return true;
+    case TRACE_REC_TIME:
+        if (!get_svarint(&sdelta)) return false;
+        read_time += sdelta;
+        rec->time = read_time;
+        return true;
+    case TRACE_REC_INPUT:
+        if (!get_svarint(&x) || !get_svarint(&y)) return false;
+        rec->x = (lv_coord_t)x;
+        rec->y = (lv_coord_t)y;
+        rec->pressed = (tag & TRACE_PRESSED) != 0;
+        return true;
+    default:
+        printf("[trace] unknown record 0x%02x\n", (unsigned)tag);
+        return false;
+    }
+}
+
+/**
+ * LEB128: 7 bits per byte, the high bit tells that more bytes follow
+ */
+static void put_varint(uint64_t v)
+{
+    while (v >= 0x80) {
+        fputc((int)(v & 0x7F) | 0x80, capture_file);
+        v >>= 7;
+    }
+    fputc((int)v, capture_file);
+}
+
+/**
+ * Zigzag: small negative values get short codes too
+ */
+static void put_svarint(int64_t v)
+{
+    put_varint(((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+}
+
+static bool get_varint(uint64_t *v)
+{
+    *v = 0;
+    for(int shift = 0; shift < 64; shift += 7) {
+        int c = fgetc(read_file);
+        if (c == EOF) return false;
+        *v |= (uint64_t)(c & 0x7F) << shift;
+        if (!(c & 0x80)) return true;
+    }
+
+    return false;
+}
+
+static bool get_svarint(int64_t *v)
+{
+    uint64_t u;
+    if (!get_varint(&u)) return false;
+    *v = (int64_t)(u >> 1) ^ -(int64_t)(u & 1);
+    return true;
+}
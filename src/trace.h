@@ -0,0 +1,108 @@
+/**
+ * @file trace.h
+ * Capture of the render loop's inputs into a compact binary trace
+ *
+ * Rendering only depends on the LVGL tick, the touch events and the RTC
+ * readings of the timekeeper. The main loop records the tick of every
+ * `lv_timer_handler()` call, every queued touch event and every RTC read,
+ * so src/replay.c can run the same workload headlessly and hash the frames.
+ * The trace is written through a buffered file, most records take 2..6 bytes:
+ *
+ *     header  "WRPL", version, hor_res, ver_res (u16 LE), start tick (u32 LE), flags
+ *     step    0x01, tick delta (varint)
+ *     time    0x02, local time delta in ms (zigzag varint)
+ *     input   0x03 | 0x80 if pressed, x, y (zigzag varint)
+ *
+ * The time is stored as local time (UTC + the host's offset), so the trace
+ * replays the same clock in any time zone.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "lvgl/lvgl.h"
+#include "app_conf.h"
+#include <stdbool.h>
+
+#define TRACE_VERSION       2
+#define TRACE_FLAG_SPLASH   0x01    /*The pre-rendered splash was on the panel (see splash.h)*/
+
+typedef enum {
+    TRACE_REC_STEP = 1,             /*`lv_timer_handler()` call*/
+    TRACE_REC_TIME,                 /*RTC read of the timekeeper*/
+    TRACE_REC_INPUT,                /*Touch event queued*/
+} trace_rec_type_t;
+
+typedef struct {
+    uint16_t hor_res;
+    uint16_t ver_res;
+    uint32_t start_tick;            /*LVGL tick when the UI was created*/
+    uint8_t flags;                  /*TRACE_FLAG_...*/
+} trace_header_t;
+
+typedef struct {
+    trace_rec_type_t type;
+    uint32_t tick;                  /*STEP: absolute tick*/
+    int64_t time;                   /*TIME: local time [ms]*/
+    lv_coord_t x;                   /*INPUT*/
+    lv_coord_t y;
+    bool pressed;
+} trace_rec_t;
+
+/**
+ * Create a trace file and write its header. Call it right before `watch_ui_create()`.
+ * @param path      file to write
+ * @param hdr       resolution, current tick and flags
+ * @return          false if the file can't be created
+ */
+bool trace_capture_start(const char *path, const trace_header_t *hdr);
+
+/**
+ * Flush and close the trace, print its size
+ */
+void trace_capture_stop(void);
+
+/**
+ * Record a `lv_timer_handler()` call (no-op if no capture is running)
+ * @param tick      `lv_tick_get()` right before the call
+ */
+void trace_capture_step(uint32_t tick);
+
+/**
+ * Record a touch event as it is queued (no-op if no capture is running)
+ */
+void trace_capture_input(lv_coord_t x, lv_coord_t y, bool pressed);
+
+/**
+ * RTC for `timekeeper_set_rtc()`: `timekeeper_system_time()`, recorded if a capture is running
+ */
+int64_t trace_capture_time(void);
+
+/**
+ * Open a trace for reading
+ * @param path      file to read
+ * @param hdr       store the header here
+ * @return          false if the file can't be read or isn't a trace of this version
+ */
+bool trace_open(const char *path, trace_header_t *hdr);
+
+/**
+ * Read the next record
+ * @param rec       store the record here
+ * @return          false at the end of the trace (or on a truncated record)
+ */
+bool trace_read(trace_rec_t *rec);
+
+/**
+ * Get the next record without consuming it
+ * @param rec       store the record here
+ * @return          false at the end of the trace
+ */
+bool trace_peek(trace_rec_t *rec);
+
+/**
+ * Close the trace opened with `trace_open()`
+ */
+void trace_close(void);
+
+#endif /*TRACE_H*/
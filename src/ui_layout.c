@@ -0,0 +1,70 @@
+/**
+ * @file ui_layout.c
+ * Declarative layout of the watch screens, resolved ahead of time
+ */
+
+#include "ui_layout.h"
+#include "app_font.h"
+#include "clock_widget.h"
+
+// The fonts (see app_font.h) and the offsets come from the display profile, as the text styles of app_theme.c
+const ui_layout_desc_t ui_layout_descs[_UI_LAYOUT_CNT] = {
+    [UI_LAYOUT_WELCOME] = { "welcome", UI_LAYOUT_TEXT, &APP_UI_FONT_WELCOME, "Welcome", 0, 0 },
+    [UI_LAYOUT_CLOCK] = { "clock", UI_LAYOUT_CLOCK_CELLS, &APP_UI_FONT_CLOCK, NULL, 0, APP_LAYOUT_CLOCK_Y },
+    [UI_LAYOUT_DATE] = { "date", UI_LAYOUT_ROW, &APP_UI_FONT_DATE, NULL, 0, APP_LAYOUT_DATE_Y },
+};
+
+#if APP_UI_LAYOUT_AOT
+// Generated by tools/layout_gen
+extern const ui_layout_rect_t ui_layout_rects[_UI_LAYOUT_CNT];
+#else
+static ui_layout_rect_t ui_layout_rects[_UI_LAYOUT_CNT];
+static bool resolved;
+#endif
+
+void ui_layout_resolve(ui_layout_rect_t *rects)
+{
+    for(int i = 0; i < _UI_LAYOUT_CNT; i++) {
+        const ui_layout_desc_t *desc = &ui_layout_descs[i];
+        lv_point_t size;
+
+        switch(desc->kind) {
+            case UI_LAYOUT_TEXT:
+                lv_txt_get_size(&size, desc->text, desc->font, 0, 0, LV_COORD_MAX, LV_TEXT_FLAG_NONE);
+                break;
+            case UI_LAYOUT_ROW:
+                size.x = SCREEN_WIDTH;
+                size.y = lv_font_get_line_height(desc->font);
+                break;
+            case UI_LAYOUT_CLOCK_CELLS:
+                clock_widget_get_size(desc->font, &size);
+                break;
+        }
+
+        // Same rounding as LV_ALIGN_CENTER
+        rects[i].x = (lv_coord_t)(SCREEN_WIDTH / 2 - size.x / 2 + desc->x_ofs);
+        rects[i].y = (lv_coord_t)(SCREEN_HEIGHT / 2 - size.y / 2 + desc->y_ofs);
+        rects[i].w = size.x;
+        rects[i].h = size.y;
+    }
+}
+
+const ui_layout_rect_t *ui_layout_get(void)
+{
+#if !APP_UI_LAYOUT_AOT
+    if (!resolved) {
+        ui_layout_resolve(ui_layout_rects);
+        resolved = true;
+    }
+#endif
+
+    return ui_layout_rects;
+}
+
+void ui_layout_place(lv_obj_t *obj, ui_layout_id_t id)
+{
+    const ui_layout_rect_t *r = &ui_layout_get()[id];
+
+    lv_obj_set_pos(obj, r->x, r->y);
+    lv_obj_set_size(obj, r->w, r->h);
+}
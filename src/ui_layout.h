@@ -0,0 +1,72 @@
+/**
+ * @file ui_layout.h
+ * Declarative layout of the watch screens, resolved ahead of time
+ *
+ * Every element of the screens is described by its font, the text it is
+ * measured with and its offset from the screen center. The description is
+ * resolved into absolute rectangles on the SCREEN_WIDTH x SCREEN_HEIGHT screen
+ * by tools/layout_gen at build time (`APP_UI_LAYOUT_AOT`), so the screens are
+ * built with `lv_obj_set_pos()`/`lv_obj_set_size()` only: no text measurement
+ * and no alignment when the objects are created. Without the generated table
+ * the same resolution runs once at the first `ui_layout_get()`.
+ */
+
+#ifndef UI_LAYOUT_H
+#define UI_LAYOUT_H
+
+#include "lvgl/lvgl.h"
+#include "app_conf.h"
+
+typedef enum {
+    UI_LAYOUT_WELCOME,                  /*"Welcome" of the loading screen*/
+    UI_LAYOUT_CLOCK,                    /*HH:MM:SS clock widget*/
+    UI_LAYOUT_DATE,                     /*Date row of the time screen*/
+    _UI_LAYOUT_CNT
+} ui_layout_id_t;
+
+typedef enum {
+    UI_LAYOUT_TEXT,                     /*Sized to the text*/
+    UI_LAYOUT_ROW,                      /*Full screen width, text's height (for texts changing their width)*/
+    UI_LAYOUT_CLOCK_CELLS,              /*Sized as clock_widget.h lays out its cells*/
+} ui_layout_kind_t;
+
+typedef struct {
+    const char *name;
+    ui_layout_kind_t kind;
+    const lv_font_t *font;
+    const char *text;                   /*Text to measure (UI_LAYOUT_TEXT)*/
+    lv_coord_t x_ofs;                   /*Offset of the element's center from the screen's center*/
+    lv_coord_t y_ofs;
+} ui_layout_desc_t;
+
+typedef struct {
+    lv_coord_t x;                       /*Position in the (unpadded) screen container*/
+    lv_coord_t y;
+    lv_coord_t w;
+    lv_coord_t h;
+} ui_layout_rect_t;
+
+/*The description of the elements, indexed by `ui_layout_id_t`*/
+extern const ui_layout_desc_t ui_layout_descs[_UI_LAYOUT_CNT];
+
+/**
+ * Resolve the description into rectangles (used by tools/layout_gen)
+ * @param rects     store `_UI_LAYOUT_CNT` rectangles here
+ */
+void ui_layout_resolve(ui_layout_rect_t *rects);
+
+/**
+ * Get the resolved rectangles: the table generated at build time with
+ * `APP_UI_LAYOUT_AOT`, resolved on the first call otherwise
+ * @return          `_UI_LAYOUT_CNT` rectangles indexed by `ui_layout_id_t`
+ */
+const ui_layout_rect_t *ui_layout_get(void);
+
+/**
+ * Move and size an object to its resolved rectangle
+ * @param obj       object in a screen container
+ * @param id        its element
+ */
+void ui_layout_place(lv_obj_t *obj, ui_layout_id_t id);
+
+#endif /*UI_LAYOUT_H*/
@@ -0,0 +1,277 @@
+/**
+ * @file watch_ui.c
+ * Screens of the watch: "Welcome" loading screen followed by the time display
+ */
+
+#include "watch_ui.h"
+#include "app_conf.h"
+#include "app_theme.h"
+#include "clock_widget.h"
+#include "render_tier.h"
+#include "screen_mgr.h"
+#include "time_fmt.h"
+#include "timekeeper.h"
+#include "ui_layout.h"
+#include <stdio.h>
+
+// UI objects
+static lv_obj_t *time_label = NULL;
+static lv_obj_t *date_label = NULL;
+static clock_widget_t clock_widget;
+static char date_text[TIME_FMT_DATE_LEN];  // shown by date_label without a copy
+static lv_timer_t *loading_timer = NULL;
+static lv_timer_t *clock_timer = NULL;
+static bool splash_prerendered = false;
+#if APP_AOD
+static lv_timer_t *aod_timer = NULL;
+static bool aod_active = false;
+static bool aod_enabled = true;
+static watch_ui_aod_cb_t aod_cb = NULL;
+#endif
+
+// Function declarations
+static void create_loading_screen(lv_obj_t *screen);
+static void delete_loading_screen(void);
+static void create_time_screen(lv_obj_t *screen);
+static void style_screen(lv_obj_t *screen);
+static void loading_timer_cb(lv_timer_t *timer);
+static void clock_update_cb(lv_timer_t *timer);
+static void update_time_display(void);
+#if APP_AOD
+static void aod_timer_cb(lv_timer_t *timer);
+static void aod_set(bool en);
+#endif
+
+// The welcome tree is freed after the switch, the time screen stays
+static screen_mgr_screen_t loading_scr = { "loading", create_loading_screen, delete_loading_screen, false, NULL };
+static screen_mgr_screen_t time_scr = { "time", create_time_screen, NULL, true, NULL };
+
+void watch_ui_create(void)
+{
+    // Only the loading screen is needed for the first frame
+    screen_mgr_show(&loading_scr);
+
+    // The splash is on the panel already: drop the invalidations so LVGL doesn't draw over it.
+    // The container's percentage size is resolved first, or the layout update of the first
+    // refresh would invalidate the whole screen again.
+    if (splash_prerendered) {
+        lv_obj_update_layout(lv_scr_act());
+        _lv_inv_area(lv_disp_get_default(), NULL);
+    }
+
+    // Build the time screen once the first frame is out
+    screen_mgr_prebuild(&time_scr, APP_SCREEN_PREBUILD_DELAY);
+}
+
+void watch_ui_set_prerendered_splash(bool en)
+{
+    splash_prerendered = en;
+}
+
+void watch_ui_create_splash(lv_obj_t *screen)
+{
+    style_screen(screen);
+
+    // Create "Welcome" label
+    lv_obj_t *welcome_label = lv_label_create(screen);
+    lv_label_set_text_static(welcome_label, ui_layout_descs[UI_LAYOUT_WELCOME].text);
+    app_theme_apply(welcome_label, APP_THEME_TEXT_LARGE);
+    ui_layout_place(welcome_label, UI_LAYOUT_WELCOME);
+}
+
+#if APP_AOD
+void watch_ui_set_aod_cb(watch_ui_aod_cb_t cb)
+{
+    aod_cb = cb;
+}
+
+void watch_ui_wake(void)
+{
+    if (!aod_active) return;
+
+    aod_set(false);
+
+    // Count the timeout from now again
+    lv_timer_set_period(aod_timer, APP_AOD_TIMEOUT);
+    lv_timer_reset(aod_timer);
+    lv_timer_resume(aod_timer);
+}
+
+void watch_ui_set_aod_enabled(bool en)
+{
+    aod_enabled = en;
+    if (!aod_timer) return;
+
+    if (en) {
+        if (aod_active) return;
+        // Check the inactivity right away
+        lv_timer_resume(aod_timer);
+        lv_timer_ready(aod_timer);
+    } else {
+        watch_ui_wake();
+        lv_timer_pause(aod_timer);
+    }
+}
+
+bool watch_ui_is_aod(void)
+{
+    return aod_active;
+}
+#endif
+
+/**
+ * Black, borderless, unpadded, not scrollable screen container
+ */
+static void style_screen(lv_obj_t *screen)
+{
+    app_theme_apply(screen, APP_THEME_SCREEN);
+    lv_obj_clear_flag(screen, LV_OBJ_FLAG_SCROLLABLE);
+    // The text on it can take the fast path
+    render_tier_watch_bg(screen);
+}
+
+/**
+ * Create the loading screen with "Welcome" text
+ */
+static void create_loading_screen(lv_obj_t *screen)
+{
+    // With a pre-rendered splash only the empty screen is needed to cover it later
+    if (splash_prerendered) {
+        style_screen(screen);
+    } else {
+        watch_ui_create_splash(screen);
+    }
+
+    // Create timer to switch to time screen after 4 seconds
+    loading_timer = lv_timer_create(loading_timer_cb, 4000, NULL);
+    lv_timer_set_repeat_count(loading_timer, 1);
+}
+
+/**
+ * Release the loading timer if the screen is replaced before it fired
+ */
+static void delete_loading_screen(void)
+{
+    if (loading_timer) lv_timer_del(loading_timer);
+    loading_timer = NULL;
+}
+
+/**
+ * Create the time display screen
+ */
+static void create_time_screen(lv_obj_t *screen)
+{
+    style_screen(screen);
+
+    // Create time label (HH:MM:SS), one cell per character
+    time_label = clock_widget_create(&clock_widget, screen, ui_layout_descs[UI_LAYOUT_CLOCK].font, lv_color_white());
+    ui_layout_place(time_label, UI_LAYOUT_CLOCK);
+
+    // Create date label
+    date_label = lv_label_create(screen);
+    lv_label_set_text_static(date_label, date_text);
+    app_theme_apply(date_label, APP_THEME_TEXT_SMALL);
+    ui_layout_place(date_label, UI_LAYOUT_DATE);
+
+    // Update time immediately, then right after every second edge
+    clock_timer = lv_timer_create(clock_update_cb, 1000, NULL);
+    update_time_display();
+
+#if APP_AOD
+    // Checks the inactivity only when the timeout could have expired
+    aod_timer = lv_timer_create(aod_timer_cb, APP_AOD_TIMEOUT, NULL);
+    if (!aod_enabled) lv_timer_pause(aod_timer);
+#endif
+}
+
+/**
+ * Timer callback to switch from loading to time screen
+ */
+static void loading_timer_cb(lv_timer_t *timer)
+{
+    // One-shot: LVGL deletes the timer after this call
+    loading_timer = NULL;
+
+    // Show time screen (built already if the prebuild ran) and free the loading screen
+    screen_mgr_show(&time_scr);
+
+    printf("Switched to time display\n");
+}
+
+/**
+ * Timer callback to update clock display
+ */
+static void clock_update_cb(lv_timer_t *timer)
+{
+    update_time_display();
+}
+
+/**
+ * Update the time display from the cached time of the timekeeper and schedule
+ * the next update on the next second (or minute) edge.
+ * Formats in place and uses static label text, so nothing is allocated.
+ */
+static void update_time_display(void)
+{
+    time_fmt_tm_t tm;
+    char time_str[TIME_FMT_HMS_LEN];
+    uint32_t period_s = 1;
+
+    uint32_t changed = timekeeper_update(&tm);
+
+    // Format time (HH:MM:SS)
+    time_fmt_hms(time_str, &tm);
+#if APP_AOD
+    // Only the minutes are shown: update them when they change
+    if (aod_active) {
+        time_str[CLOCK_WIDGET_HM_CNT] = '\0';
+        period_s = 60;
+    }
+#endif
+    clock_widget_set_text(&clock_widget, time_str);
+
+    // Measured from now, so a late call doesn't delay the following ones
+    lv_timer_reset(clock_timer);
+    lv_timer_set_period(clock_timer, timekeeper_ms_to_next(period_s));
+
+    // The date only changes once a day
+    if (!(changed & TIMEKEEPER_CHANGED_DAY)) return;
+
+    // Format date (Day, Mon DD YYYY) into the label's static text
+    time_fmt_date(date_text, &tm);
+    lv_label_set_text_static(date_label, date_text);
+}
+
+#if APP_AOD
+/**
+ * Enter the always-on mode once the display was inactive for the timeout on the time screen
+ */
+static void aod_timer_cb(lv_timer_t *timer)
+{
+    uint32_t inactive = lv_disp_get_inactive_time(NULL);
+    if (inactive < APP_AOD_TIMEOUT || screen_mgr_get_act() != &time_scr) {
+        // Check again when the timeout could expire next
+        lv_timer_set_period(timer, inactive < APP_AOD_TIMEOUT ? APP_AOD_TIMEOUT - inactive : APP_AOD_TIMEOUT);
+        return;
+    }
+
+    lv_timer_pause(timer);
+    aod_set(true);
+}
+
+/**
+ * Switch the clock and the panel. Only the clock's cells are invalidated:
+ * the seconds when they are hidden or shown, then the changed digits.
+ */
+static void aod_set(bool en)
+{
+    aod_active = en;
+    printf(en ? "Always-on display\n" : "Active display\n");
+
+    clock_widget_show_seconds(&clock_widget, !en);
+    if (aod_cb) aod_cb(en);
+
+    // Show the current time now, then follow the minutes (or the seconds again)
+    update_time_display();
+}
+#endif
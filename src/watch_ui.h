@@ -0,0 +1,64 @@
+/**
+ * @file watch_ui.h
+ * Screens of the watch: "Welcome" loading screen followed by the time display
+ */
+
+#ifndef WATCH_UI_H
+#define WATCH_UI_H
+
+#include "lvgl/lvgl.h"
+#include "app_conf.h"
+#include <stdbool.h>
+
+/*Switch the panel in or out of its low power mode (e.g. the 8 colour idle mode, IDMON/IDMOFF)*/
+typedef void (*watch_ui_aod_cb_t)(bool en);
+
+/**
+ * Show the loading screen on the default display. The time screen is built in
+ * the background shortly after and shown after 4 seconds, when the loading
+ * screen is deleted.
+ */
+void watch_ui_create(void);
+
+/**
+ * Build the content of the loading screen ("Welcome" on black) into a container.
+ * Also used by tools/splash_gen to pre-render it.
+ * @param screen    full screen container
+ */
+void watch_ui_create_splash(lv_obj_t *screen);
+
+/**
+ * Tell `watch_ui_create()` that the splash was already written to the panel
+ * (see splash.h): the loading screen is created without content and not rendered.
+ * @param en        true if the splash is on the panel
+ */
+void watch_ui_set_prerendered_splash(bool en);
+
+#if APP_AOD
+/**
+ * Set the callback switching the panel's idle mode when the always-on mode
+ * is entered or left (see `APP_AOD`)
+ * @param cb        the callback, NULL if the panel has no idle mode
+ */
+void watch_ui_set_aod_cb(watch_ui_aod_cb_t cb);
+
+/**
+ * Leave the always-on mode on user activity (call it when an input event arrives).
+ * The idle timeout itself follows the display's inactivity time.
+ */
+void watch_ui_wake(void);
+
+/**
+ * Allow or forbid the always-on mode (allowed by default). Forbidding it also
+ * leaves the mode, e.g. for benchmarks which need the seconds to tick.
+ * @param en        true to enter the mode after the idle timeout
+ */
+void watch_ui_set_aod_enabled(bool en);
+
+/**
+ * Tell whether the always-on mode is active
+ */
+bool watch_ui_is_aod(void);
+#endif
+
+#endif /*WATCH_UI_H*/
@@ -0,0 +1,567 @@
+/**
+ * @file font_subset.c
+ * Build time tool: subset the fonts of the display profile to the characters
+ * the screens draw and write them as LVGL fonts (see app_font.h)
+ *
+ * Usage: font_subset <output.c> [--bpp=1|2|4|8] [--compress]
+ *
+ * The glyphs, metrics and kerning are taken from the fonts built into LVGL.
+ * `--bpp` requantizes the glyphs, `--compress` stores them in LVGL's RLE format
+ * (needs `LV_USE_FONT_COMPRESSED`); every compressed glyph is decoded again
+ * and compared before it's written.
+ */
+
+#include "lvgl/lvgl.h"
+#include "app_conf.h"
+#include "app_font.h"
+#include "ui_layout.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_GLYPHS  128
+#define STR(x)      STR_(x)
+#define STR_(x)     #x
+
+typedef struct {
+    const char *name;                   // name of the generated font
+    const char *src_name;
+    const lv_font_t *src;
+    const char *chars;                  // drawn characters, in any order and with duplicates
+} subset_t;
+
+typedef struct {
+    uint8_t *data;
+    uint32_t cap;
+    uint32_t bit_pos;
+} bit_buf_t;
+
+typedef struct {
+    uint32_t letter;
+    uint32_t src_id;
+    const lv_font_fmt_txt_glyph_dsc_t *src_dsc;
+    uint32_t bitmap_index;
+} glyph_t;
+
+// LVGL's RLE decoder states
+enum { RLE_SINGLE, RLE_REPEAT, RLE_COUNTER };
+
+static bool write_font(FILE *f, const subset_t *subset, uint8_t bpp, bool compress, uint32_t *size);
+static uint32_t collect_letters(const char *chars, uint32_t *letters);
+static uint32_t get_src_id(const lv_font_fmt_txt_dsc_t *dsc, uint32_t letter);
+static int8_t get_src_kern(const lv_font_fmt_txt_dsc_t *dsc, uint32_t left, uint32_t right);
+static uint32_t get_src_glyph_cnt(const lv_font_fmt_txt_dsc_t *dsc);
+static void get_glyph_px(const lv_font_t *font, const glyph_t *g, uint8_t bpp, uint8_t *px);
+static void encode_rle(bit_buf_t *b, const uint8_t *px, uint32_t w, uint32_t h, uint8_t bpp);
+static bool decode_rle_check(const uint8_t *in, const uint8_t *px, uint32_t w, uint32_t h, uint8_t bpp);
+static void put_bits(bit_buf_t *b, uint32_t v, uint8_t len);
+static uint8_t get_bits(const uint8_t *in, uint32_t bit_pos, uint8_t len);
+static void write_bytes(FILE *f, const uint8_t *data, uint32_t size);
+
+int main(int argc, char **argv)
+{
+    uint8_t bpp = 4;
+    bool compress = false;
+
+    if (argc < 2) {
+        printf("Usage: %s <output.c> [--bpp=1|2|4|8] [--compress]\n", argv[0]);
+        return 1;
+    }
+    for(int i = 2; i < argc; i++) {
+        if (strncmp(argv[i], "--bpp=", 6) == 0) {
+            bpp = (uint8_t)atoi(argv[i] + 6);
+            if (bpp == 1 || bpp == 2 || bpp == 4 || bpp == 8) continue;
+        }
+        if (strcmp(argv[i], "--compress") == 0) {
+            compress = true;
+            continue;
+        }
+        printf("Usage: %s <output.c> [--bpp=1|2|4|8] [--compress]\n", argv[0]);
+        return 1;
+    }
+
+    lv_init();
+
+    const subset_t subsets[] = {
+        { "app_font_welcome", STR(APP_FONT_WELCOME), &APP_FONT_WELCOME, ui_layout_descs[UI_LAYOUT_WELCOME].text },
+        { "app_font_clock", STR(APP_FONT_CLOCK), &APP_FONT_CLOCK, APP_FONT_CLOCK_CHARS },
+        { "app_font_date", STR(APP_FONT_DATE), &APP_FONT_DATE, APP_FONT_DATE_CHARS },
+    };
+
+    FILE *f = fopen(argv[1], "w");
+    if (!f) {
+        printf("Can't open %s\n", argv[1]);
+        return 1;
+    }
+
+    fprintf(f, "/*Generated by tools/font_subset, don't edit*/\n\n");
+    fprintf(f, "#include \"src/app_font.h\"\n\n");
+    fprintf(f, "#if APP_DISPLAY_PROFILE != %d\n", APP_DISPLAY_PROFILE);
+    fprintf(f, "#error \"The fonts were generated for another display profile\"\n");
+    fprintf(f, "#endif\n");
+    if (compress) {
+        fprintf(f, "#if !LV_USE_FONT_COMPRESSED\n");
+        fprintf(f, "#error \"The fonts are compressed, enable LV_USE_FONT_COMPRESSED\"\n");
+        fprintf(f, "#endif\n");
+    }
+
+    bool ok = true;
+    for(uint32_t i = 0; i < sizeof(subsets) / sizeof(subsets[0]) && ok; i++) {
+        uint32_t size;
+        ok = write_font(f, &subsets[i], bpp, compress, &size);
+        if (ok) printf("Font %s: %s subset, %u bpp%s, ~%u bytes\n", subsets[i].name, subsets[i].src_name,
+                           (unsigned)bpp, compress ? " compressed" : "", (unsigned)size);
+    }
+
+    if (fclose(f) != 0) ok = false;
+
+    return ok ? 0 : 1;
+}
+
+/**
+ * Write the subset of a font
+ * @param size      store the approximate size of the font's data here
+ */
+static bool write_font(FILE *f, const subset_t *subset, uint8_t bpp, bool compress, uint32_t *size)
+{
+    const lv_font_fmt_txt_dsc_t *dsc = subset->src->dsc;
+    uint32_t letters[MAX_GLYPHS];
+    glyph_t glyphs[MAX_GLYPHS];
+
+    uint32_t cnt = collect_letters(subset->chars, letters);
+    if (cnt == 0) {
+        printf("%s: no characters\n", subset->name);
+        return false;
+    }
+
+    for(uint32_t i = 0; i < cnt; i++) {
+        glyphs[i].letter = letters[i];
+        glyphs[i].src_id = get_src_id(dsc, letters[i]);
+        if (glyphs[i].src_id == 0) {
+            printf("%s: '%c' is not in %s\n", subset->name, (char)letters[i], subset->src_name);
+            return false;
+        }
+        glyphs[i].src_dsc = &dsc->glyph_dsc[glyphs[i].src_id];
+    }
+
+    // Glyphs start on byte boundaries, the RLE decoder may read one byte past the last one
+    bit_buf_t bitmap = { 0 };
+    for(uint32_t i = 0; i < cnt; i++) {
+        const glyph_t *g = &glyphs[i];
+        uint32_t w = g->src_dsc->box_w;
+        uint32_t h = g->src_dsc->box_h;
+        uint8_t *px = malloc(w * h + 1);
+        if (!px) return false;
+
+        get_glyph_px(subset->src, g, bpp, px);
+        glyphs[i].bitmap_index = bitmap.bit_pos / 8;
+        uint32_t start = bitmap.bit_pos;
+        if (compress) {
+            encode_rle(&bitmap, px, w, h, bpp);
+        } else {
+            for(uint32_t p = 0; p < w * h; p++) put_bits(&bitmap, px[p], bpp);
+        }
+        bitmap.bit_pos = (bitmap.bit_pos + 7) & ~7u;
+
+        bool valid = !compress || decode_rle_check(bitmap.data + start / 8, px, w, h, bpp);
+        free(px);
+        if (!valid) {
+            printf("%s: the compressed '%c' doesn't decode\n", subset->name, (char)g->letter);
+            free(bitmap.data);
+            return false;
+        }
+    }
+    uint32_t bitmap_size = bitmap.bit_pos / 8 + 1;
+
+    fprintf(f, "\n/*%s: \"", subset->name);
+    for(uint32_t i = 0; i < cnt; i++) fputc((int)letters[i], f);
+    fprintf(f, "\" of %s (%u of %u glyphs, %u bpp)*/\n\n", subset->src_name, (unsigned)cnt,
+            (unsigned)get_src_glyph_cnt(dsc), (unsigned)bpp);
+
+    fprintf(f, "static LV_ATTRIBUTE_LARGE_CONST const uint8_t %s_bitmap[] = {", subset->name);
+    write_bytes(f, bitmap.data, bitmap_size);
+    fprintf(f, "\n};\n\n");
+    free(bitmap.data);
+
+    // Glyph 0 is reserved
+    fprintf(f, "static const lv_font_fmt_txt_glyph_dsc_t %s_glyph_dsc[] = {\n", subset->name);
+    fprintf(f, "    { .bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0 },\n");
+    for(uint32_t i = 0; i < cnt; i++) {
+        const lv_font_fmt_txt_glyph_dsc_t *d = glyphs[i].src_dsc;
+        fprintf(f, "    { .bitmap_index = %u, .adv_w = %u, .box_w = %u, .box_h = %u, .ofs_x = %d, .ofs_y = %d },"
+                   "  /*'%c'*/\n", (unsigned)glyphs[i].bitmap_index, (unsigned)d->adv_w, (unsigned)d->box_w,
+                (unsigned)d->box_h, (int)d->ofs_x, (int)d->ofs_y, (char)glyphs[i].letter);
+    }
+    fprintf(f, "};\n\n");
+
+    fprintf(f, "static const uint16_t %s_unicode_list[] = {", subset->name);
+    for(uint32_t i = 0; i < cnt; i++) {
+        fprintf(f, "%s%u", i ? ", " : " ", (unsigned)(letters[i] - letters[0]));
+    }
+    fprintf(f, " };\n\n");
+
+    fprintf(f, "static const lv_font_fmt_txt_cmap_t %s_cmaps[] = {\n", subset->name);
+    fprintf(f, "    { .range_start = %u, .range_length = %u, .glyph_id_start = 1, .unicode_list = %s_unicode_list,\n"
+               "      .glyph_id_ofs_list = NULL, .list_length = %u, .type = LV_FONT_FMT_TXT_CMAP_SPARSE_TINY },\n",
+            (unsigned)letters[0], (unsigned)(letters[cnt - 1] - letters[0] + 1), subset->name, (unsigned)cnt);
+    fprintf(f, "};\n\n");
+
+    // Kerning as pairs of the new glyph ids, sorted by left then right id as LVGL searches them
+    uint32_t pair_cnt = 0;
+    for(uint32_t l = 0; l < cnt; l++) {
+        for(uint32_t r = 0; r < cnt; r++) {
+            if (get_src_kern(dsc, glyphs[l].src_id, glyphs[r].src_id) != 0) pair_cnt++;
+        }
+    }
+    if (pair_cnt > 0) {
+        fprintf(f, "static const uint8_t %s_kern_ids[] = {", subset->name);
+        uint32_t n = 0;
+        for(uint32_t l = 0; l < cnt; l++) {
+            for(uint32_t r = 0; r < cnt; r++) {
+                if (get_src_kern(dsc, glyphs[l].src_id, glyphs[r].src_id) == 0) continue;
+                fprintf(f, "%s%u, %u,", n++ % 8 ? " " : "\n    ", (unsigned)l + 1, (unsigned)r + 1);
+            }
+        }
+        fprintf(f, "\n};\n\n");
+
+        fprintf(f, "static const int8_t %s_kern_values[] = {", subset->name);
+        n = 0;
+        for(uint32_t l = 0; l < cnt; l++) {
+            for(uint32_t r = 0; r < cnt; r++) {
+                int8_t v = get_src_kern(dsc, glyphs[l].src_id, glyphs[r].src_id);
+                if (v == 0) continue;
+                fprintf(f, "%s%d,", n++ % 16 ? " " : "\n    ", (int)v);
+            }
+        }
+        fprintf(f, "\n};\n\n");
+
+        fprintf(f, "static const lv_font_fmt_txt_kern_pair_t %s_kern_pairs = {\n", subset->name);
+        fprintf(f, "    .glyph_ids = %s_kern_ids, .values = %s_kern_values, .pair_cnt = %u, .glyph_ids_size = 0\n",
+                subset->name, subset->name, (unsigned)pair_cnt);
+        fprintf(f, "};\n\n");
+    }
+
+    fprintf(f, "static lv_font_fmt_txt_glyph_cache_t %s_cache;\n\n", subset->name);
+    fprintf(f, "static const lv_font_fmt_txt_dsc_t %s_dsc = {\n", subset->name);
+    fprintf(f, "    .glyph_bitmap = %s_bitmap,\n", subset->name);
+    fprintf(f, "    .glyph_dsc = %s_glyph_dsc,\n", subset->name);
+    fprintf(f, "    .cmaps = %s_cmaps,\n", subset->name);
+    if (pair_cnt > 0) {
+        fprintf(f, "    .kern_dsc = &%s_kern_pairs,\n", subset->name);
+    } else {
+        fprintf(f, "    .kern_dsc = NULL,\n");
+    }
+    fprintf(f, "    .kern_scale = %u,\n", (unsigned)dsc->kern_scale);
+    fprintf(f, "    .cmap_num = 1,\n");
+    fprintf(f, "    .bpp = %u,\n", (unsigned)bpp);
+    fprintf(f, "    .kern_classes = 0,\n");
+    fprintf(f, "    .bitmap_format = %s,\n", compress ? "LV_FONT_FMT_TXT_COMPRESSED" : "LV_FONT_FMT_TXT_PLAIN");
+    fprintf(f, "    .cache = &%s_cache,\n", subset->name);
+    fprintf(f, "};\n\n");
+
+    const lv_font_t *src = subset->src;
+    fprintf(f, "const lv_font_t %s = {\n", subset->name);
+    fprintf(f, "    .get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt,\n");
+    fprintf(f, "    .get_glyph_bitmap = lv_font_get_bitmap_fmt_txt,\n");
+    fprintf(f, "    .line_height = %d,\n", (int)src->line_height);
+    fprintf(f, "    .base_line = %d,\n", (int)src->base_line);
+    fprintf(f, "    .subpx = LV_FONT_SUBPX_NONE,\n");
+    fprintf(f, "    .underline_position = %d,\n", (int)src->underline_position);
+    fprintf(f, "    .underline_thickness = %d,\n", (int)src->underline_thickness);
+    fprintf(f, "    .dsc = &%s_dsc,\n", subset->name);
+    fprintf(f, "};\n");
+
+    *size = bitmap_size + (cnt + 1) * (uint32_t)sizeof(lv_font_fmt_txt_glyph_dsc_t) + cnt * 2 + pair_cnt * 3 +
+            (uint32_t)(sizeof(lv_font_fmt_txt_cmap_t) + sizeof(lv_font_fmt_txt_dsc_t) + sizeof(lv_font_t));
+
+    return true;
+}
+
+/**
+ * Sort and deduplicate the characters
+ * @return          the number of letters, 0 on a non-ASCII character or too many of them
+ */
+static uint32_t collect_letters(const char *chars, uint32_t *letters)
+{
+    bool used[128] = { false };
+
+    for(const char *c = chars; *c != '\0'; c++) {
+        if ((uint8_t)*c >= 128) return 0;
+        used[(uint8_t)*c] = true;
+    }
+
+    uint32_t cnt = 0;
+    for(uint32_t c = 0; c < 128; c++) {
+        if (used[c]) letters[cnt++] = c;
+    }
+
+    return cnt;
+}
+
+/**
+ * Look up the glyph id of a letter in the font (0: not found)
+ */
+static uint32_t get_src_id(const lv_font_fmt_txt_dsc_t *dsc, uint32_t letter)
+{
+    for(uint32_t i = 0; i < dsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t *cmap = &dsc->cmaps[i];
+        uint32_t rcp = letter - cmap->range_start;
+        if (letter < cmap->range_start || rcp >= cmap->range_length) continue;
+
+        switch(cmap->type) {
+            case LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY:
+                return cmap->glyph_id_start + rcp;
+            case LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL:
+                return cmap->glyph_id_start + ((const uint8_t *)cmap->glyph_id_ofs_list)[rcp];
+            case LV_FONT_FMT_TXT_CMAP_SPARSE_TINY:
+            case LV_FONT_FMT_TXT_CMAP_SPARSE_FULL:
+                for(uint32_t j = 0; j < cmap->list_length; j++) {
+                    if (cmap->unicode_list[j] != rcp) continue;
+                    if (cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_TINY) return cmap->glyph_id_start + j;
+                    return cmap->glyph_id_start + ((const uint16_t *)cmap->glyph_id_ofs_list)[j];
+                }
+                break;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Get the raw kerning value of a glyph pair (in `kern_scale` units)
+ */
+static int8_t get_src_kern(const lv_font_fmt_txt_dsc_t *dsc, uint32_t left, uint32_t right)
+{
+    if (!dsc->kern_dsc) return 0;
+
+    if (dsc->kern_classes) {
+        const lv_font_fmt_txt_kern_classes_t *kc = dsc->kern_dsc;
+        uint8_t lc = kc->left_class_mapping[left];
+        uint8_t rc = kc->right_class_mapping[right];
+        if (lc == 0 || rc == 0) return 0;
+        return kc->class_pair_values[(lc - 1) * kc->right_class_cnt + (rc - 1)];
+    }
+
+    const lv_font_fmt_txt_kern_pair_t *kp = dsc->kern_dsc;
+    for(uint32_t i = 0; i < kp->pair_cnt; i++) {
+        uint32_t l, r;
+        if (kp->glyph_ids_size == 0) {
+            l = ((const uint8_t *)kp->glyph_ids)[i * 2];
+            r = ((const uint8_t *)kp->glyph_ids)[i * 2 + 1];
+        } else {
+            l = ((const uint16_t *)kp->glyph_ids)[i * 2];
+            r = ((const uint16_t *)kp->glyph_ids)[i * 2 + 1];
+        }
+        if (l == left && r == right) return kp->values[i];
+    }
+
+    return 0;
+}
+
+static uint32_t get_src_glyph_cnt(const lv_font_fmt_txt_dsc_t *dsc)
+{
+    uint32_t max_id = 0;
+
+    for(uint32_t i = 0; i < dsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t *cmap = &dsc->cmaps[i];
+        uint32_t cnt = cmap->list_length ? cmap->list_length : cmap->range_length;
+        uint32_t last = cmap->glyph_id_start + cnt - 1;
+        if (last > max_id) max_id = last;
+    }
+
+    return max_id;
+}
+
+/**
+ * Get the pixels of a glyph requantized to `bpp`, one per byte
+ */
+static void get_glyph_px(const lv_font_t *font, const glyph_t *g, uint8_t bpp, uint8_t *px)
+{
+    const lv_font_fmt_txt_dsc_t *dsc = font->dsc;
+    uint32_t cnt = (uint32_t)g->src_dsc->box_w * g->src_dsc->box_h;
+    uint8_t src_bpp = dsc->bpp;
+    const uint8_t *src;
+    uint8_t step = src_bpp;
+
+    if (dsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN) {
+        src = dsc->glyph_bitmap + g->src_dsc->bitmap_index;
+    } else {
+        // Decompressed by LVGL, 3 bpp pixels are written on 4 bits
+        src = lv_font_get_bitmap_fmt_txt(font, g->letter);
+        if (src_bpp == 3) step = 4;
+    }
+
+    uint32_t src_max = (1u << src_bpp) - 1;
+    uint32_t max = (1u << bpp) - 1;
+    for(uint32_t i = 0; i < cnt; i++) {
+        uint32_t v = get_bits(src, i * step, src_bpp);
+        px[i] = (uint8_t)((v * max + src_max / 2) / src_max);
+    }
+}
+
+/**
+ * Encode a glyph in the compressed format of LVGL's lv_font_fmt_txt.c: every
+ * row XORed with the previous one, then RLE coded as its decoder expects it
+ */
+static void encode_rle(bit_buf_t *b, const uint8_t *px, uint32_t w, uint32_t h, uint8_t bpp)
+{
+    uint32_t n = w * h;
+    uint8_t *vals = malloc(n + 1);
+    if (!vals) return;
+
+    for(uint32_t i = 0; i < n; i++) {
+        vals[i] = i < w ? px[i] : px[i] ^ px[i - w];
+    }
+
+    int state = RLE_SINGLE;
+    uint8_t prev = 0;
+    uint32_t cnt = 0;
+    for(uint32_t i = 0; i < n; i++) {
+        uint8_t v = vals[i];
+
+        if (state == RLE_SINGLE) {
+            put_bits(b, v, bpp);
+            if (i != 0 && v == prev) {
+                cnt = 0;
+                state = RLE_REPEAT;
+            }
+            prev = v;
+        } else if (state == RLE_REPEAT) {
+            cnt++;
+            if (v != prev) {
+                put_bits(b, 0, 1);
+                put_bits(b, v, bpp);
+                prev = v;
+                state = RLE_SINGLE;
+            } else {
+                put_bits(b, 1, 1);
+                if (cnt == 11) {
+                    // Counter c: c - 1 more repeats, then a literal
+                    uint32_t r = 0;
+                    while (r < 62 && i + 1 + r < n && vals[i + 1 + r] == prev) r++;
+                    cnt = r + 1;
+                    put_bits(b, cnt, 6);
+                    state = RLE_COUNTER;
+                }
+            }
+        } else {
+            cnt--;
+            if (cnt == 0) {
+                put_bits(b, v, bpp);
+                prev = v;
+                state = RLE_SINGLE;
+            }
+        }
+    }
+
+    free(vals);
+}
+
+/**
+ * Decode a compressed glyph as lv_font_fmt_txt.c does and compare it with the pixels
+ */
+static bool decode_rle_check(const uint8_t *in, const uint8_t *px, uint32_t w, uint32_t h, uint8_t bpp)
+{
+    int state = RLE_SINGLE;
+    uint32_t rdp = 0;
+    uint8_t prev = 0;
+    uint32_t cnt = 0;
+
+    for(uint32_t i = 0; i < w * h; i++) {
+        uint8_t ret = 0;
+
+        if (state == RLE_SINGLE) {
+            ret = get_bits(in, rdp, bpp);
+            if (rdp != 0 && prev == ret) {
+                cnt = 0;
+                state = RLE_REPEAT;
+            }
+            prev = ret;
+            rdp += bpp;
+        } else if (state == RLE_REPEAT) {
+            uint8_t v = get_bits(in, rdp, 1);
+            cnt++;
+            rdp++;
+            if (v == 1) {
+                ret = prev;
+                if (cnt == 11) {
+                    cnt = get_bits(in, rdp, 6);
+                    rdp += 6;
+                    if (cnt != 0) {
+                        state = RLE_COUNTER;
+                    } else {
+                        ret = get_bits(in, rdp, bpp);
+                        prev = ret;
+                        rdp += bpp;
+                        state = RLE_SINGLE;
+                    }
+                }
+            } else {
+                ret = get_bits(in, rdp, bpp);
+                prev = ret;
+                rdp += bpp;
+                state = RLE_SINGLE;
+            }
+        } else {
+            ret = prev;
+            cnt--;
+            if (cnt == 0) {
+                ret = get_bits(in, rdp, bpp);
+                prev = ret;
+                rdp += bpp;
+                state = RLE_SINGLE;
+            }
+        }
+
+        uint8_t expected = i < w ? px[i] : px[i] ^ px[i - w];
+        if (ret != expected) return false;
+    }
+
+    return true;
+}
+
+/**
+ * Append bits, MSB first. At least one zero byte stays allocated after them.
+ */
+static void put_bits(bit_buf_t *b, uint32_t v, uint8_t len)
+{
+    uint32_t need = (b->bit_pos + len + 7) / 8 + 1;
+    if (need > b->cap) {
+        uint32_t cap = b->cap ? b->cap * 2 : 1024;
+        while (cap < need) cap *= 2;
+        uint8_t *data = realloc(b->data, cap);
+        if (!data) {
+            printf("Out of memory\n");
+            exit(1);
+        }
+        memset(data + b->cap, 0, cap - b->cap);
+        b->data = data;
+        b->cap = cap;
+    }
+
+    for(int i = len - 1; i >= 0; i--) {
+        if (v & (1u << i)) b->data[b->bit_pos / 8] |= (uint8_t)(0x80 >> (b->bit_pos % 8));
+        b->bit_pos++;
+    }
+}
+
+/**
+ * Read bits, MSB first
+ */
+static uint8_t get_bits(const uint8_t *in, uint32_t bit_pos, uint8_t len)
+{
+    uint8_t v = 0;
+
+    for(uint8_t i = 0; i < len; i++, bit_pos++) {
+        v = (uint8_t)((v << 1) | ((in[bit_pos / 8] >> (7 - bit_pos % 8)) & 1));
+    }
+
+    return v;
+}
+
+static void write_bytes(FILE *f, const uint8_t *data, uint32_t size)
+{
+    for(uint32_t i = 0; i < size; i++) {
+        fprintf(f, "%s0x%02x,", i % 16 ? " " : "\n    ", data ? data[i] : 0);
+    }
+}
@@ -0,0 +1,55 @@
+/**
+ * @file layout_gen.c
+ * Build time tool: resolve the screen layout (see ui_layout.h) and write it as a constant table
+ *
+ * Usage: layout_gen <output.c>
+ */
+
+#include "lvgl/lvgl.h"
+#include "app_conf.h"
+#include "ui_layout.h"
+#include <stdio.h>
+
+static bool write_c_file(const char *path, const ui_layout_rect_t *rects);
+
+int main(int argc, char **argv)
+{
+    if (argc != 2) {
+        printf("Usage: %s <output.c>\n", argv[0]);
+        return 1;
+    }
+
+    // Only the fonts are used, no display is needed
+    lv_init();
+
+    ui_layout_rect_t rects[_UI_LAYOUT_CNT];
+    ui_layout_resolve(rects);
+
+    bool ok = write_c_file(argv[1], rects);
+    if (ok) printf("Layout %dx%d: %d elements\n", SCREEN_WIDTH, SCREEN_HEIGHT, _UI_LAYOUT_CNT);
+
+    return ok ? 0 : 1;
+}
+
+static bool write_c_file(const char *path, const ui_layout_rect_t *rects)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        printf("Can't open %s\n", path);
+        return false;
+    }
+
+    fprintf(f, "/*Generated by tools/layout_gen, don't edit*/\n\n");
+    fprintf(f, "#include \"src/ui_layout.h\"\n\n");
+    fprintf(f, "#if SCREEN_WIDTH != %d || SCREEN_HEIGHT != %d\n", SCREEN_WIDTH, SCREEN_HEIGHT);
+    fprintf(f, "#error \"The layout was generated for another screen size\"\n");
+    fprintf(f, "#endif\n\n");
+    fprintf(f, "const ui_layout_rect_t ui_layout_rects[_UI_LAYOUT_CNT] = {\n");
+    for(int i = 0; i < _UI_LAYOUT_CNT; i++) {
+        fprintf(f, "    { %d, %d, %d, %d },  /*%s*/\n", (int)rects[i].x, (int)rects[i].y, (int)rects[i].w,
+                (int)rects[i].h, ui_layout_descs[i].name);
+    }
+    fprintf(f, "};\n");
+
+    return fclose(f) == 0;
+}
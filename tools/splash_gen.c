@@ -0,0 +1,82 @@
+/**
+ * @file splash_gen.c
+ * Build time tool: render the loading screen and write it as a splash blob (see splash.h)
+ *
+ * Usage: splash_gen <output.c>
+ */
+
+#include "lvgl/lvgl.h"
+#include "app_conf.h"
+#include "app_theme.h"
+#include "draw_buf.h"
+#include "mem_display.h"
+#include "splash.h"
+#include "watch_ui.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static bool write_c_file(const char *path, const uint8_t *blob, size_t size);
+
+int main(int argc, char **argv)
+{
+    if (argc != 2) {
+        printf("Usage: %s <output.c>\n", argv[0]);
+        return 1;
+    }
+
+    lv_init();
+    if (!mem_display_init(SCREEN_WIDTH, SCREEN_HEIGHT)) {
+        printf("Can't allocate the framebuffer\n");
+        return 1;
+    }
+
+    // Render the splash exactly as the application would, into a RAM framebuffer
+    static lv_disp_drv_t disp_drv;
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.flush_cb = mem_display_flush;
+    disp_drv.hor_res = SCREEN_WIDTH;
+    disp_drv.ver_res = SCREEN_HEIGHT;
+    if (!draw_buf_setup(&disp_drv, DRAW_BUF_FULL, 0)) return 1;
+    lv_disp_t *disp = lv_disp_drv_register(&disp_drv);
+    app_theme_init(disp, APP_THEME_MINIMAL);
+
+    lv_obj_t *cont = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(cont, lv_pct(100), lv_pct(100));
+    watch_ui_create_splash(cont);
+    lv_refr_now(disp);
+
+    size_t px_cnt = (size_t)SCREEN_WIDTH * SCREEN_HEIGHT;
+    size_t out_size = SPLASH_HEADER_SIZE + px_cnt * 2 + px_cnt / 128 + 1;
+    uint8_t *blob = malloc(out_size);
+    if (!blob) return 1;
+
+    const uint16_t *px = (const uint16_t *)mem_display_get_fb();
+    size_t size = splash_encode(px, SCREEN_WIDTH, SCREEN_HEIGHT, blob, out_size);
+    bool ok = size && write_c_file(argv[1], blob, size);
+    if (ok) printf("Splash %dx%d: %u bytes (%u raw)\n", SCREEN_WIDTH, SCREEN_HEIGHT, (unsigned)size, (unsigned)(px_cnt * 2));
+
+    free(blob);
+    mem_display_deinit();
+
+    return ok ? 0 : 1;
+}
+
+static bool write_c_file(const char *path, const uint8_t *blob, size_t size)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        printf("Can't open %s\n", path);
+        return false;
+    }
+
+    fprintf(f, "/*Generated by tools/splash_gen, don't edit*/\n\n");
+    fprintf(f, "#include \"src/splash.h\"\n\n");
+    fprintf(f, "const uint8_t splash_blob[] = {");
+    for(size_t i = 0; i < size; i++) {
+        fprintf(f, "%s0x%02x,", i % 16 ? " " : "\n    ", blob[i]);
+    }
+    fprintf(f, "\n};\n\n");
+    fprintf(f, "const uint32_t splash_blob_size = %u;\n", (unsigned)size);
+
+    return fclose(f) == 0;
+}